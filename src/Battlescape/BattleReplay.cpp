@@ -0,0 +1,374 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattleReplay.h"
+#include <fstream>
+#include <algorithm>
+#include <yaml-cpp/yaml.h>
+#include <SDL.h>
+#include "BattlescapeGame.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/RNG.h"
+#include "../Savegame/SavedGame.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/BattleItem.h"
+#include "../Savegame/Tile.h"
+
+namespace OpenXcom
+{
+
+BattleReplay *BattleReplay::_playing = 0;
+const std::string BattleReplay::EXTENSION = ".replay";
+const std::string BattleReplay::RECORDING = "_replay_";
+
+/**
+ * Mixes a value into a checksum (FNV-1a).
+ * @param hash Checksum so far.
+ * @param value Value to add.
+ */
+static void mix(unsigned int &hash, int value)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		hash ^= (value >> (i * 8)) & 0xFF;
+		hash *= 16777619u;
+	}
+}
+
+/**
+ * Creates a replay of a battle.
+ * @param name Name of the replay, without extension.
+ * @param recording True to record a new replay, false to play it back.
+ */
+BattleReplay::BattleReplay(const std::string &name, bool recording) : _name(name), _recording(recording), _seed(0), _pathPreview(PATH_NONE), _strafe(false), _confirmFire(false), _nextAction(0), _nextChecksum(0), _mismatches(0)
+{
+}
+
+/**
+ * Saves the recording, or reports the results of the play back
+ * and gives the player back their settings.
+ */
+BattleReplay::~BattleReplay()
+{
+	if (_recording)
+	{
+		try
+		{
+			save();
+		}
+		catch (Exception &e)
+		{
+			Log(LOG_ERROR) << e.what();
+		}
+	}
+	else if (_playing == this)
+	{
+		report();
+		Profiler::setTotals(false);
+		swapSettings();
+		_playing = 0;
+	}
+}
+
+/**
+ * Gets the replay currently being played back.
+ * @return Pointer to the replay, or 0 if none.
+ */
+BattleReplay *BattleReplay::getPlaying()
+{
+	return _playing;
+}
+
+/**
+ * Gets the save file a replay starts from.
+ * @param name Name of the replay.
+ * @return Filename of the save.
+ */
+std::string BattleReplay::getSaveName(const std::string &name)
+{
+	return name + ".asav";
+}
+
+/**
+ * Calculates a checksum of everything the player's inputs
+ * and the aliens' decisions act on, so a play back that
+ * went a different way can be caught.
+ * @param battle Pointer to the battle.
+ * @return Checksum.
+ */
+unsigned int BattleReplay::checksum(SavedBattleGame *battle)
+{
+	unsigned int hash = 2166136261u;
+	uint64_t seed = RNG::getSeed();
+	mix(hash, battle->getTurn());
+	mix(hash, battle->getSide());
+	mix(hash, (int)seed);
+	mix(hash, (int)(seed >> 32));
+	for (std::vector<BattleUnit*>::iterator i = battle->getUnits()->begin(); i != battle->getUnits()->end(); ++i)
+	{
+		mix(hash, (*i)->getId());
+		mix(hash, (*i)->getPosition().x);
+		mix(hash, (*i)->getPosition().y);
+		mix(hash, (*i)->getPosition().z);
+		mix(hash, (*i)->getDirection());
+		mix(hash, (*i)->getStatus());
+		mix(hash, (*i)->getFaction());
+		mix(hash, (*i)->getHealth());
+		mix(hash, (*i)->getStunlevel());
+		mix(hash, (*i)->getTimeUnits());
+		mix(hash, (*i)->getEnergy());
+		mix(hash, (*i)->getMorale());
+	}
+	mix(hash, (int)battle->getItems()->size());
+	for (int i = 0; i < battle->getMapSizeXYZ(); ++i)
+	{
+		Tile *tile = battle->getTiles()[i];
+		if (tile->getFire() || tile->getSmoke())
+		{
+			mix(hash, i);
+			mix(hash, tile->getFire());
+			mix(hash, tile->getSmoke());
+		}
+	}
+	return hash;
+}
+
+/**
+ * Starts recording a battle. The game is saved as it is
+ * now, along with the settings that change how inputs work.
+ * @param game Pointer to the game.
+ */
+void BattleReplay::start(SavedGame *game)
+{
+	_seed = RNG::getSeed();
+	_pathPreview = Options::battleNewPreviewPath;
+	_strafe = Options::strafe;
+	_confirmFire = Options::battleConfirmFireMode;
+	game->save(getSaveName(_name));
+	save();
+}
+
+/**
+ * Swaps the settings that change how inputs work
+ * between the replay and the player's options.
+ */
+void BattleReplay::swapSettings()
+{
+	PathPreview pathPreview = Options::battleNewPreviewPath;
+	Options::battleNewPreviewPath = (PathPreview)_pathPreview;
+	_pathPreview = pathPreview;
+	std::swap(Options::strafe, _strafe);
+	std::swap(Options::battleConfirmFireMode, _confirmFire);
+}
+
+/**
+ * Starts playing back a battle that has just been loaded from
+ * the replay's save. The RNG is put back where it was when the
+ * recording started, and the player's settings are swapped
+ * with the recorded ones until the replay is done.
+ */
+void BattleReplay::play()
+{
+	load();
+	RNG::setSeed(_seed);
+	swapSettings();
+	Profiler::setTotals(true);
+	_playing = this;
+	Log(LOG_INFO) << "Playing back replay " << _name << " with " << _actions.size() << " inputs.";
+}
+
+/**
+ * Loads the replay from a YAML file.
+ */
+void BattleReplay::load()
+{
+	std::string filename = Options::getMasterUserFolder() + _name + EXTENSION;
+	YAML::Node doc = YAML::LoadFile(filename);
+	_seed = doc["seed"].as<uint64_t>(_seed);
+	_pathPreview = doc["pathPreview"].as<int>(_pathPreview);
+	_strafe = doc["strafe"].as<bool>(_strafe);
+	_confirmFire = doc["confirmFire"].as<bool>(_confirmFire);
+	_actions.clear();
+	for (YAML::const_iterator i = doc["actions"].begin(); i != doc["actions"].end(); ++i)
+	{
+		ReplayAction action;
+		action.turn = (*i)["turn"].as<int>(action.turn);
+		action.input = (ReplayInput)(*i)["input"].as<int>(action.input);
+		action.unit = (*i)["unit"].as<int>(action.unit);
+		action.weapon = (*i)["weapon"].as<int>(action.weapon);
+		action.type = (*i)["type"].as<int>(action.type);
+		action.targeting = (*i)["targeting"].as<bool>(action.targeting);
+		action.modifier = (*i)["modifier"].as<bool>(action.modifier);
+		action.TU = (*i)["TU"].as<int>(action.TU);
+		action.value = (*i)["value"].as<int>(action.value);
+		action.target = (*i)["target"].as<Position>(action.target);
+		action.waypoints = (*i)["waypoints"].as< std::vector<Position> >(action.waypoints);
+		_actions.push_back(action);
+	}
+	_checksums = doc["checksums"].as< std::vector<unsigned int> >(_checksums);
+}
+
+/**
+ * Saves the replay to a YAML file.
+ */
+void BattleReplay::save() const
+{
+	std::string filename = Options::getMasterUserFolder() + _name + EXTENSION;
+	std::ofstream out(filename.c_str());
+	if (!out)
+	{
+		throw Exception("Failed to save " + _name + EXTENSION);
+	}
+	YAML::Node doc;
+	doc["save"] = getSaveName(_name);
+	doc["seed"] = _seed;
+	doc["pathPreview"] = _pathPreview;
+	doc["strafe"] = _strafe;
+	doc["confirmFire"] = _confirmFire;
+	for (std::vector<ReplayAction>::const_iterator i = _actions.begin(); i != _actions.end(); ++i)
+	{
+		YAML::Node node;
+		node["turn"] = i->turn;
+		node["input"] = (int)i->input;
+		if (i->unit != -1)
+			node["unit"] = i->unit;
+		if (i->weapon != -1)
+			node["weapon"] = i->weapon;
+		if (i->type != BA_NONE)
+			node["type"] = i->type;
+		if (i->targeting)
+			node["targeting"] = i->targeting;
+		if (i->modifier)
+			node["modifier"] = i->modifier;
+		if (i->TU != 0)
+			node["TU"] = i->TU;
+		if (i->value != 0)
+			node["value"] = i->value;
+		node["target"] = i->target;
+		if (!i->waypoints.empty())
+			node["waypoints"] = i->waypoints;
+		doc["actions"].push_back(node);
+	}
+	doc["checksums"] = _checksums;
+	YAML::Emitter emitter;
+	emitter << doc;
+	out << emitter.c_str() << std::endl;
+}
+
+/**
+ * Checks if this replay is being recorded.
+ * @return True if recording.
+ */
+bool BattleReplay::isRecording() const
+{
+	return _recording;
+}
+
+/**
+ * Records a player input, along with the unit that was
+ * selected and the action being set up at the time.
+ * @param input Type of input.
+ * @param battle Pointer to the battle.
+ * @param action Action being set up.
+ * @param target Position the input was made on, if any.
+ * @param value Setting chosen by the input, if any.
+ */
+void BattleReplay::record(ReplayInput input, SavedBattleGame *battle, const BattleAction &action, Position target, int value)
+{
+	ReplayAction replay;
+	replay.turn = battle->getTurn();
+	replay.input = input;
+	replay.unit = battle->getSelectedUnit() ? battle->getSelectedUnit()->getId() : -1;
+	replay.weapon = action.weapon ? action.weapon->getId() : -1;
+	replay.type = action.type;
+	replay.targeting = action.targeting;
+	replay.modifier = (SDL_GetModState() & KMOD_CTRL) != 0;
+	replay.TU = action.TU;
+	replay.value = (input == REPLAY_NON_TARGET) ? action.value : value;
+	replay.target = target;
+	replay.waypoints.assign(action.waypoints.begin(), action.waypoints.end());
+	_actions.push_back(replay);
+}
+
+/**
+ * Gets the next recorded input to play back.
+ * @return Pointer to the input, or 0 if there are none left.
+ */
+const ReplayAction *BattleReplay::getNextAction() const
+{
+	if (_nextAction < _actions.size())
+	{
+		return &_actions[_nextAction];
+	}
+	return 0;
+}
+
+/**
+ * Moves on to the next recorded input.
+ */
+void BattleReplay::nextAction()
+{
+	_nextAction++;
+}
+
+/**
+ * Records the checksum of the battle at the start of a turn,
+ * or compares it with the recorded one when playing back.
+ * @param battle Pointer to the battle.
+ */
+void BattleReplay::checkTurn(SavedBattleGame *battle)
+{
+	unsigned int sum = checksum(battle);
+	if (_recording)
+	{
+		_checksums.push_back(sum);
+		save();
+	}
+	else if (_playing == this)
+	{
+		if (_nextChecksum < _checksums.size() && _checksums[_nextChecksum] != sum)
+		{
+			Log(LOG_ERROR) << "Replay " << _name << " went a different way on turn " << battle->getTurn() << ", side " << battle->getSide() << ".";
+			_mismatches++;
+		}
+		_nextChecksum++;
+	}
+}
+
+/**
+ * Logs how far the play back got, whether it matched
+ * the recording, and where the time went.
+ */
+void BattleReplay::report() const
+{
+	Log(LOG_INFO) << "Replay " << _name << ": played " << _nextAction << "/" << _actions.size() << " inputs, checked " << _nextChecksum << "/" << _checksums.size() << " turns, " << _mismatches << " mismatches.";
+	for (int i = 0; i < PROFILE_SECTIONS; ++i)
+	{
+		ProfileSection section = (ProfileSection)i;
+		if (!Profiler::isTopLevel(section) && Profiler::getTotalCalls(section) != 0)
+		{
+			Log(LOG_INFO) << "Replay " << _name << ": " << Profiler::getName(section) << " " << Profiler::getTotalTime(section) * 1000.0 << " ms in " << Profiler::getTotalCalls(section) << " calls.";
+		}
+	}
+}
+
+}
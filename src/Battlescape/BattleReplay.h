@@ -0,0 +1,113 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+class SavedGame;
+class SavedBattleGame;
+struct BattleAction;
+
+/// Player inputs to the battlescape that can be replayed.
+enum ReplayInput { REPLAY_PRIMARY, REPLAY_SECONDARY, REPLAY_LAUNCH, REPLAY_PSI, REPLAY_MOVE_UP, REPLAY_MOVE_DOWN, REPLAY_KNEEL, REPLAY_NON_TARGET, REPLAY_CANCEL, REPLAY_RESERVE, REPLAY_RESERVE_KNEEL, REPLAY_ACTIVE_HAND, REPLAY_END_TURN };
+
+/**
+ * A player input recorded during a battle, along with
+ * the selected unit and the action being set up at the time.
+ */
+struct ReplayAction
+{
+	int turn;
+	ReplayInput input;
+	int unit, weapon;
+	int type;
+	bool targeting, modifier;
+	int TU, value;
+	Position target;
+	std::vector<Position> waypoints;
+	ReplayAction() : turn(0), input(REPLAY_PRIMARY), unit(-1), weapon(-1), type(0), targeting(false), modifier(false), TU(0), value(0) { }
+};
+
+/**
+ * Records the player's inputs during a battle so it can be played
+ * back later. The battle starts from a save taken when recording
+ * begins and the RNG seed at that point, so the aliens make the same
+ * moves again. The state of the battle is checked at the start of
+ * every turn, and the time spent in the expensive parts of the
+ * battlescape is added up while playing back.
+ */
+class BattleReplay
+{
+private:
+	static BattleReplay *_playing;
+	std::string _name;
+	bool _recording;
+	uint64_t _seed;
+	int _pathPreview;
+	bool _strafe, _confirmFire;
+	std::vector<ReplayAction> _actions;
+	std::vector<unsigned int> _checksums;
+	size_t _nextAction, _nextChecksum;
+	int _mismatches;
+
+	/// Swaps the recorded settings with the player's.
+	void swapSettings();
+public:
+	/// Extension of replay files.
+	static const std::string EXTENSION;
+	/// Name of the replay recorded during play.
+	static const std::string RECORDING;
+	/// Creates a replay to record or play back.
+	BattleReplay(const std::string &name, bool recording);
+	/// Cleans up the replay.
+	~BattleReplay();
+	/// Gets the replay being played back, if any.
+	static BattleReplay *getPlaying();
+	/// Gets the save a replay starts from.
+	static std::string getSaveName(const std::string &name);
+	/// Calculates a checksum of the state of a battle.
+	static unsigned int checksum(SavedBattleGame *battle);
+	/// Starts recording from the current state of the game.
+	void start(SavedGame *game);
+	/// Starts playing back, restoring the recorded settings.
+	void play();
+	/// Loads the replay from its file.
+	void load();
+	/// Saves the replay to its file.
+	void save() const;
+	/// Is this replay being recorded?
+	bool isRecording() const;
+	/// Records a player input.
+	void record(ReplayInput input, SavedBattleGame *battle, const BattleAction &action, Position target, int value);
+	/// Gets the next input to play back.
+	const ReplayAction *getNextAction() const;
+	/// Moves on to the next input.
+	void nextAction();
+	/// Records or checks the state of the battle at the start of a turn.
+	void checkTurn(SavedBattleGame *battle);
+	/// Logs the results of the play back.
+	void report() const;
+};
+
+}
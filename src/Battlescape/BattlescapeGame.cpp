@@ -55,8 +55,11 @@
 #include "InfoboxOKState.h"
 #include "UnitFallBState.h"
 #include "../Engine/Logger.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Profiler.h"
 #include "../Savegame/BattleUnitStatistics.h"
 #include "../fmath.h"
+#include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
 {
@@ -68,7 +71,7 @@ bool BattlescapeGame::_debugPlay = false;
  * @param save Pointer to the save game.
  * @param parentState Pointer to the parent battlescape state.
  */
-BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) : _save(save), _parentState(parentState), _playerPanicHandled(true), _AIActionCounter(0), _AISecondMove(false), _playedAggroSound(false), _endTurnRequested(false), _endTurnProcessed(false)
+BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) : _save(save), _parentState(parentState), _playerPanicHandled(true), _AIActionCounter(0), _AISecondMove(false), _playedAggroSound(false), _endTurnRequested(false), _endTurnProcessed(false), _replay(0)
 {
 
 	_currentAction.actor = 0;
@@ -77,6 +80,36 @@ BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parent
 
 	_debugPlay = false;
 
+	if (!Options::getReplay().empty())
+	{
+		_replay = new BattleReplay(Options::getReplay(), false);
+		try
+		{
+			_replay->play();
+			_parentState->setStateInterval(1);
+		}
+		catch (YAML::Exception &e)
+		{
+			Log(LOG_ERROR) << "Failed to load replay " << Options::getReplay() << ": " << e.what();
+			delete _replay;
+			_replay = 0;
+		}
+	}
+	else if (Options::battleRecordReplay)
+	{
+		_replay = new BattleReplay(BattleReplay::RECORDING, true);
+		try
+		{
+			_replay->start(_parentState->getGame()->getSavedGame());
+		}
+		catch (Exception &e)
+		{
+			Log(LOG_ERROR) << e.what();
+			delete _replay;
+			_replay = 0;
+		}
+	}
+
 	checkForCasualties(0, 0, true);
 	cancelCurrentAction();
 }
@@ -92,6 +125,12 @@ BattlescapeGame::~BattlescapeGame()
 		delete *i;
 	}
 	cleanupDeleted();
+	if (isReplaying())
+	{
+		// the play back is over, the results are in the log
+		_parentState->getGame()->quit();
+	}
+	delete _replay;
 }
 
 /**
@@ -145,6 +184,10 @@ void BattlescapeGame::think()
 				_playerPanicHandled = handlePanickingPlayer();
 				_save->getBattleState()->updateSoldierInfo();
 			}
+			else if (isReplaying())
+			{
+				playReplay();
+			}
 		}
 	}
 }
@@ -226,12 +269,15 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 	BattleAction action;
 	action.actor = unit;
 	action.number = _AIActionCounter;
-	unit->think(&action);
-
-	if (action.type == BA_RETHINK)
 	{
-		_parentState->debug("Rethink");
+		ProfileTimer timer(PROFILE_AI);
 		unit->think(&action);
+
+		if (action.type == BA_RETHINK)
+		{
+			_parentState->debug("Rethink");
+			unit->think(&action);
+		}
 	}
 
 	_AIActionCounter = action.number;
@@ -431,6 +477,11 @@ void BattlescapeGame::endTurn()
 
 	_endTurnProcessed = false;
 
+	if (_replay)
+	{
+		_replay->checkTurn(_save);
+	}
+
 	if (_save->getSide() == FACTION_PLAYER)
 	{
 		setupCursor();
@@ -792,7 +843,15 @@ void BattlescapeGame::showInfoBoxQueue()
 {
 	for (std::vector<InfoboxOKState*>::iterator i = _infoboxQueue.begin(); i != _infoboxQueue.end(); ++i)
 	{
-		_parentState->getGame()->pushState(*i);
+		// nobody is there to click them away during a play back
+		if (isReplaying())
+		{
+			delete *i;
+		}
+		else
+		{
+			_parentState->getGame()->pushState(*i);
+		}
 	}
 
 	_infoboxQueue.clear();
@@ -1151,7 +1210,8 @@ bool BattlescapeGame::noActionsPending(BattleUnit *bu)
  */
 void BattlescapeGame::setStateInterval(Uint32 interval)
 {
-	_parentState->setStateInterval(interval);
+	// play backs run as fast as they can
+	_parentState->setStateInterval(isReplaying() ? 1 : interval);
 }
 
 
@@ -2223,4 +2283,124 @@ void BattlescapeGame::autoEndBattle()
 	}
 }
 
+/**
+ * Records a player input, so it can be played back later.
+ * @param input Type of input.
+ * @param pos Position the input was made on, if any.
+ * @param value Setting chosen by the input, if any.
+ */
+void BattlescapeGame::recordInput(ReplayInput input, Position pos, int value)
+{
+	if (_replay && _replay->isRecording())
+	{
+		_replay->record(input, _save, _currentAction, pos, value);
+	}
+}
+
+/**
+ * Checks if a recorded battle is being played back,
+ * in which case the player's inputs come from the recording.
+ * @return True if playing back.
+ */
+bool BattlescapeGame::isReplaying() const
+{
+	return _replay && !_replay->isRecording();
+}
+
+/**
+ * Plays back the next recorded player input. The selected unit
+ * and the action being set up are restored to what they were when
+ * the input was recorded, then the input is handled as usual.
+ * Once all the inputs have been played back, the game is over.
+ */
+void BattlescapeGame::playReplay()
+{
+	const ReplayAction *next = _replay->getNextAction();
+	if (!next)
+	{
+		_parentState->getGame()->quit();
+		return;
+	}
+	if (next->turn != _save->getTurn())
+	{
+		Log(LOG_ERROR) << "Replay expected turn " << next->turn << " but the battle is on turn " << _save->getTurn() << ".";
+		_parentState->getGame()->quit();
+		return;
+	}
+	_replay->nextAction();
+
+	BattleUnit *unit = 0;
+	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	{
+		if ((*i)->getId() == next->unit)
+		{
+			unit = *i;
+			break;
+		}
+	}
+	BattleItem *weapon = 0;
+	for (std::vector<BattleItem*>::iterator i = _save->getItems()->begin(); i != _save->getItems()->end(); ++i)
+	{
+		if ((*i)->getId() == next->weapon)
+		{
+			weapon = *i;
+			break;
+		}
+	}
+	_save->setSelectedUnit(unit);
+	_currentAction.actor = unit;
+	_currentAction.weapon = weapon;
+	_currentAction.type = (BattleActionType)next->type;
+	_currentAction.targeting = next->targeting;
+	_currentAction.TU = next->TU;
+	_currentAction.value = next->value;
+	_currentAction.waypoints.assign(next->waypoints.begin(), next->waypoints.end());
+	getMap()->getWaypoints()->assign(next->waypoints.begin(), next->waypoints.end());
+	SDL_SetModState(next->modifier ? KMOD_LCTRL : KMOD_NONE);
+
+	switch (next->input)
+	{
+	case REPLAY_PRIMARY:
+		primaryAction(next->target);
+		break;
+	case REPLAY_SECONDARY:
+		secondaryAction(next->target);
+		break;
+	case REPLAY_LAUNCH:
+		launchAction();
+		break;
+	case REPLAY_PSI:
+		psiButtonAction();
+		break;
+	case REPLAY_MOVE_UP:
+		moveUpDown(unit, Pathfinding::DIR_UP);
+		break;
+	case REPLAY_MOVE_DOWN:
+		moveUpDown(unit, Pathfinding::DIR_DOWN);
+		break;
+	case REPLAY_KNEEL:
+		kneel(unit);
+		break;
+	case REPLAY_NON_TARGET:
+		handleNonTargetAction();
+		break;
+	case REPLAY_CANCEL:
+		cancelCurrentAction(next->value != 0);
+		break;
+	case REPLAY_RESERVE:
+		setTUReserved((BattleActionType)next->value);
+		break;
+	case REPLAY_RESERVE_KNEEL:
+		setKneelReserved(next->value != 0);
+		break;
+	case REPLAY_ACTIVE_HAND:
+		unit->setActiveHand(next->value ? "STR_RIGHT_HAND" : "STR_LEFT_HAND");
+		break;
+	case REPLAY_END_TURN:
+		requestEndTurn();
+		break;
+	}
+	_parentState->updateSoldierInfo();
+}
+
 }
@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http:///www.gnu.org/licenses/>.
  */
 #include "Position.h"
+#include "BattleReplay.h"
 #include <SDL.h>
 #include <string>
 #include <list>
@@ -88,6 +89,9 @@ private:
 	std::vector<InfoboxOKState*> _infoboxQueue;
 	/// Shows the infoboxes in the queue (if any).
 	void showInfoBoxQueue();
+	BattleReplay *_replay;
+	/// Plays back the next recorded player input.
+	void playReplay();
 public:
 	/// is debug mode enabled in the battlescape?
 	static bool _debugPlay;
@@ -194,6 +198,10 @@ public:
 	std::list<BattleState*> getStates();
 	/// Auto end the battle if conditions are met.
 	void autoEndBattle();
+	/// Records a player input, if the battle is being recorded.
+	void recordInput(ReplayInput input, Position pos = Position(), int value = 0);
+	/// Checks if a recorded battle is being played back.
+	bool isReplaying() const;
 };
 
 }
@@ -17,7 +17,6 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
-#include <fstream>
 #include <sstream>
 #include "BattlescapeGenerator.h"
 #include "TileEngine.h"
@@ -41,6 +40,7 @@
 #include "../Savegame/EquipmentLayoutItem.h"
 #include "../Engine/Game.h"
 #include "../Engine/FileMap.h"
+#include "../Engine/MappedFile.h"
 #include "../Engine/Options.h"
 #include "../Engine/RNG.h"
 #include "../Engine/Exception.h"
@@ -1561,20 +1561,24 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 {
 	int sizex, sizey, sizez;
 	int x = xoff, y = yoff, z = 0;
-	char size[3];
-	unsigned char value[4];
+	const char *size;
+	const unsigned char *value;
 	std::ostringstream filename;
 	filename << "MAPS/" << mapblock->getName() << ".MAP";
 	unsigned int terrainObjectID;
 
 	// Load file
-	std::ifstream mapFile (FileMap::getFilePath(filename.str()).c_str(), std::ios::in| std::ios::binary);
+	const MappedFile *mapFile = FileMap::mapFile(FileMap::getFilePath(filename.str()));
 	if (!mapFile)
 	{
 		throw Exception(filename.str() + " not found");
 	}
+	if (mapFile->getSize() < 3)
+	{
+		throw Exception("Invalid MAP file: " + filename.str());
+	}
 
-	mapFile.read((char*)&size, sizeof(size));
+	size = (const char*)mapFile->getData();
 	sizey = (int)size[0];
 	sizex = (int)size[1];
 	sizez = (int)size[2];
@@ -1623,8 +1627,9 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		throw Exception("Something is wrong in your map definitions, craft/ufo map is too tall?");
 	}
 
-	while (mapFile.read((char*)&value, sizeof(value)))
+	for (size_t offset = 3; offset + 4 <= mapFile->getSize(); offset += 4)
 	{
+		value = mapFile->getData() + offset;
 		for (int part = O_FLOOR; part <= O_OBJECT; ++part)
 		{
 			terrainObjectID = ((unsigned char)value[part]);
@@ -1658,13 +1663,6 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		}
 	}
 
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid MAP file: " + filename.str());
-	}
-
-	mapFile.close();
-
 	if (_generateFuel)
 	{
 		// if one of the mapBlocks has an items array defined, don't deploy fuel algorithmically
@@ -1693,12 +1691,12 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
  */
 void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int segment)
 {
-	unsigned char value[24];
+	const unsigned char *value;
 	std::ostringstream filename;
 	filename << "ROUTES/" << mapblock->getName() << ".RMP";
 
 	// Load file
-	std::ifstream mapFile (FileMap::getFilePath(filename.str()).c_str(), std::ios::in| std::ios::binary);
+	const MappedFile *mapFile = FileMap::mapFile(FileMap::getFilePath(filename.str()));
 	if (!mapFile)
 	{
 		throw Exception(filename.str() + " not found");
@@ -1707,8 +1705,9 @@ void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int s
 	size_t nodeOffset = _save->getNodes()->size();
 	std::vector<int> badNodes;
 	int nodesAdded = 0;
-	while (mapFile.read((char*)&value, sizeof(value)))
+	for (size_t offset = 0; offset + 24 <= mapFile->getSize(); offset += 24)
 	{
+		value = mapFile->getData() + offset;
 		int pos_x = value[1];
 		int pos_y = value[0];
 		int pos_z = value[2];
@@ -1776,12 +1775,6 @@ void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int s
 		}
 	}
 
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid RMP file: " + filename.str());
-	}
-
-	mapFile.close();
 }
 
 /**
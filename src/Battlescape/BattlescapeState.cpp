@@ -533,6 +533,11 @@ void BattlescapeState::init()
 			_map->getCamera()->centerOnPosition(_save->getSelectedUnit()->getPosition());
 		}
 		_firstInit = false;
+		if (_battleGame->isReplaying())
+		{
+			// play backs don't need to show anything
+			_map->setVisible(false);
+		}
 		_btnReserveNone->setGroup(&_reserve);
 		_btnReserveSnap->setGroup(&_reserve);
 		_btnReserveAimed->setGroup(&_reserve);
@@ -572,6 +577,7 @@ void BattlescapeState::think()
 			_gameTimer->think(this, 0);
 			if (popped)
 			{
+				_battleGame->recordInput(REPLAY_NON_TARGET);
 				_battleGame->handleNonTargetAction();
 				popped = false;
 			}
@@ -769,6 +775,7 @@ void BattlescapeState::mapClick(Action *action)
 	// right-click aborts walking state
 	if (action->getDetails()->button.button == SDL_BUTTON_RIGHT)
 	{
+		_battleGame->recordInput(REPLAY_CANCEL);
 		if (_battleGame->cancelCurrentAction())
 		{
 			return;
@@ -796,10 +803,12 @@ void BattlescapeState::mapClick(Action *action)
 	{
 		if ((action->getDetails()->button.button == SDL_BUTTON_RIGHT || (action->getDetails()->button.button == SDL_BUTTON_LEFT && (SDL_GetModState() & KMOD_ALT) != 0)) && playableUnitSelected())
 		{
+			_battleGame->recordInput(REPLAY_SECONDARY, pos);
 			_battleGame->secondaryAction(pos);
 		}
 		else if (action->getDetails()->button.button == SDL_BUTTON_LEFT)
 		{
+			_battleGame->recordInput(REPLAY_PRIMARY, pos);
 			_battleGame->primaryAction(pos);
 		}
 	}
@@ -824,6 +833,7 @@ void BattlescapeState::btnUnitUpClick(Action *)
 	if (playableUnitSelected() && _save->getPathfinding()->validateUpDown(_save->getSelectedUnit(), _save->getSelectedUnit()->getPosition(), Pathfinding::DIR_UP))
 	{
 		_battleGame->cancelAllActions();
+		_battleGame->recordInput(REPLAY_MOVE_UP);
 		_battleGame->moveUpDown(_save->getSelectedUnit(), Pathfinding::DIR_UP);
 	}
 }
@@ -837,6 +847,7 @@ void BattlescapeState::btnUnitDownClick(Action *)
 	if (playableUnitSelected() && _save->getPathfinding()->validateUpDown(_save->getSelectedUnit(), _save->getSelectedUnit()->getPosition(), Pathfinding::DIR_DOWN))
 	{
 		_battleGame->cancelAllActions();
+		_battleGame->recordInput(REPLAY_MOVE_DOWN);
 		_battleGame->moveUpDown(_save->getSelectedUnit(), Pathfinding::DIR_DOWN);
 	}
 }
@@ -895,6 +906,7 @@ void BattlescapeState::btnKneelClick(Action *)
 		BattleUnit *bu = _save->getSelectedUnit();
 		if (bu)
 		{
+			_battleGame->recordInput(REPLAY_KNEEL);
 			_battleGame->kneel(bu);
 			toggleKneelButton(bu);
 
@@ -1050,6 +1062,7 @@ void BattlescapeState::btnEndTurnClick(Action *)
 	if (allowButtons())
 	{
 		_txtTooltip->setText("");
+		_battleGame->recordInput(REPLAY_END_TURN);
 		_battleGame->requestEndTurn();
 	}
 }
@@ -1107,10 +1120,12 @@ void BattlescapeState::btnLeftHandItemClick(Action *)
 		// TODO: wrap this in an IFDEF ?
 		if (_battleGame->getCurrentAction()->targeting)
 		{
+			_battleGame->recordInput(REPLAY_CANCEL);
 			_battleGame->cancelCurrentAction();
 			return;
 		}
 
+		_battleGame->recordInput(REPLAY_CANCEL);
 		_battleGame->cancelCurrentAction();
 
 		BattleUnit *unit = _save->getSelectedUnit();
@@ -1118,6 +1133,7 @@ void BattlescapeState::btnLeftHandItemClick(Action *)
 
 		if (leftHandItem != getSpecialMeleeWeapon(unit))
 		{
+			_battleGame->recordInput(REPLAY_ACTIVE_HAND, Position(), 0);
 			unit->setActiveHand("STR_LEFT_HAND");
 		}
 
@@ -1140,10 +1156,12 @@ void BattlescapeState::btnRightHandItemClick(Action *)
 		// TODO: wrap this in an IFDEF ?
 		if (_battleGame->getCurrentAction()->targeting)
 		{
+			_battleGame->recordInput(REPLAY_CANCEL);
 			_battleGame->cancelCurrentAction();
 			return;
 		}
 
+		_battleGame->recordInput(REPLAY_CANCEL);
 		_battleGame->cancelCurrentAction();
 
 		BattleUnit *unit = _save->getSelectedUnit();
@@ -1151,6 +1169,7 @@ void BattlescapeState::btnRightHandItemClick(Action *)
 
 		if (rightHandItem != getSpecialMeleeWeapon(unit))
 		{
+			_battleGame->recordInput(REPLAY_ACTIVE_HAND, Position(), 1);
 			unit->setActiveHand("STR_RIGHT_HAND");
 		}
 
@@ -1191,6 +1210,7 @@ void BattlescapeState::btnVisibleUnitClick(Action *action)
  */
 void BattlescapeState::btnLaunchClick(Action *action)
 {
+	_battleGame->recordInput(REPLAY_LAUNCH);
 	_battleGame->launchAction();
 	action->getDetails()->type = SDL_NOEVENT; // consume the event
 }
@@ -1201,6 +1221,7 @@ void BattlescapeState::btnLaunchClick(Action *action)
  */
 void BattlescapeState::btnPsiClick(Action *action)
 {
+	_battleGame->recordInput(REPLAY_PSI);
 	_battleGame->psiButtonAction();
 	action->getDetails()->type = SDL_NOEVENT; // consume the event
 }
@@ -1227,6 +1248,7 @@ void BattlescapeState::btnReserveClick(Action *action)
 			_battleGame->setTUReserved(BA_AIMEDSHOT);
 		else if (_reserve == _btnReserveAuto)
 			_battleGame->setTUReserved(BA_AUTOSHOT);
+		_battleGame->recordInput(REPLAY_RESERVE, Position(), _battleGame->getReservedAction());
 
 		// update any path preview
 		if (_battleGame->getPathfinding()->isPathPreviewed())
@@ -2188,6 +2210,7 @@ void BattlescapeState::btnReserveKneelClick(Action *action)
 		Action a = Action(&ev, 0.0, 0.0, 0, 0);
 		action->getSender()->mousePress(&a, this);
 		_battleGame->setKneelReserved(!_battleGame->getKneelReserved());
+		_battleGame->recordInput(REPLAY_RESERVE_KNEEL, Position(), _battleGame->getKneelReserved());
 
 		_btnReserveKneel->toggle(_battleGame->getKneelReserved());
 
@@ -857,23 +857,15 @@ void DebriefingState::prepareDebriefing()
 		{
 			if ((*j)->isInBattlescape())
 			{
-				for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+				_region = _game->getSavedGame()->locateRegion((*j)->getLongitude(), (*j)->getLatitude());
+				if (_region)
 				{
-					if ((*k)->getRules()->insideRegion((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						_region = (*k);
-						_missionStatistics->region = _region->getRules()->getType();
-						break;
-					}
+					_missionStatistics->region = _region->getRules()->getType();
 				}
-				for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+				_country = _game->getSavedGame()->locateCountry((*j)->getLongitude(), (*j)->getLatitude());
+				if (_country)
 				{
-					if ((*k)->getRules()->insideCountry((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						_country = (*k);
-						_missionStatistics->country = _country->getRules()->getType();
-						break;
-					}
+					_missionStatistics->country = _country->getRules()->getType();
 				}
 				craft = (*j);
 				base = (*i);
@@ -917,23 +909,15 @@ void DebriefingState::prepareDebriefing()
 			target = base->getType();
 			base->setInBattlescape(false);
 			base->cleanupDefenses(false);
-			for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+			_region = _game->getSavedGame()->locateRegion(base->getLongitude(), base->getLatitude());
+			if (_region)
 			{
-				if ((*k)->getRules()->insideRegion(base->getLongitude(), base->getLatitude()))
-				{
-					_region = (*k);
-					_missionStatistics->region = _region->getRules()->getType();
-					break;
-				}
+				_missionStatistics->region = _region->getRules()->getType();
 			}
-			for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+			_country = _game->getSavedGame()->locateCountry(base->getLongitude(), base->getLatitude());
+			if (_country)
 			{
-				if ((*k)->getRules()->insideCountry(base->getLongitude(), base->getLatitude()))
-				{
-					_country = (*k);
-					_missionStatistics->country= _country->getRules()->getType();
-					break;
-				}
+				_missionStatistics->country= _country->getRules()->getType();
 			}
 			// Loop through the UFOs and see which one is sitting on top of the base... that is probably the one attacking you.
 			for (std::vector<Ufo*>::iterator k = save->getUfos()->begin(); k != save->getUfos()->end(); ++k)
@@ -18,7 +18,7 @@
  */
 #include "Map.h"
 #include "Camera.h"
-#include "UnitSprite.h"
+#include "UnitSpriteCache.h"
 #include "Pathfinding.h"
 #include "TileEngine.h"
 #include "Projectile.h"
@@ -33,6 +33,7 @@
 #include "../Engine/Palette.h"
 #include "../Engine/Game.h"
 #include "../Engine/Screen.h"
+#include "../Engine/Profiler.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Savegame/BattleUnit.h"
@@ -100,6 +101,8 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 	_message->setY((visibleMapHeight - _message->getHeight()) / 2);
 	_message->setTextColor(_messageColor);
 	_camera = new Camera(_spriteWidth, _spriteHeight, _save->getMapSizeX(), _save->getMapSizeY(), _save->getMapSizeZ(), this, visibleMapHeight);
+	_unitSprites = new UnitSpriteCache(_game->getMod(), _spriteWidth * 2, _spriteHeight, _save->getDepth() != 0);
+	_unitSprites->setPalette(getPalette());
 	_scrollMouseTimer = new Timer(SCROLL_INTERVAL);
 	_scrollMouseTimer->onTimer((SurfaceHandler)&Map::scrollMouse);
 	_scrollKeyTimer = new Timer(SCROLL_INTERVAL);
@@ -128,6 +131,7 @@ Map::~Map()
 	delete _message;
 	delete _camera;
 	delete _txtAccuracy;
+	delete _unitSprites;
 }
 
 /**
@@ -237,6 +241,7 @@ void Map::draw()
 void Map::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
+	_unitSprites->setPalette(getPalette());
 	for (std::vector<MapDataSet*>::const_iterator i = _save->getMapDataSets()->begin(); i != _save->getMapDataSets()->end(); ++i)
 	{
 		(*i)->getSurfaceset()->setPalette(colors, firstcolor, ncolors);
@@ -255,6 +260,52 @@ static bool positionHaveSameXY(Position a, Position b)
 	return a.x == b.x && a.y == b.y;
 }
 
+/**
+ * Divides rounding towards negative infinity.
+ * @param a Dividend.
+ * @param b Divisor, must be positive.
+ * @return Quotient.
+ */
+static int floorDiv(int a, int b)
+{
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * Divides rounding towards positive infinity.
+ * @param a Dividend.
+ * @param b Divisor, must be positive.
+ * @return Quotient.
+ */
+static int ceilDiv(int a, int b)
+{
+	return -floorDiv(-a, b);
+}
+
+/**
+ * Gets the rows of a map column whose tiles end up on the surface,
+ * by solving the isometric projection for the surface bounds (plus
+ * a sprite of margin) instead of projecting every tile.
+ * @param surface The surface being drawn on.
+ * @param x Column of the map.
+ * @param z Level of the map.
+ * @param beginY Returns the first visible row.
+ * @param endY Returns the last visible row, less than beginY if none.
+ */
+void Map::getVisibleRows(Surface *surface, int x, int z, int *beginY, int *endY) const
+{
+	Position offset = _camera->getMapOffset();
+	int halfWidth = _spriteWidth / 2, quarterWidth = _spriteWidth / 4;
+	int levelHeight = (_spriteHeight + _spriteWidth / 4) / 2;
+	// screen x = columnX - y * halfWidth, screen y = columnY + y * quarterWidth
+	int columnX = x * halfWidth + offset.x;
+	int columnY = x * quarterWidth - z * levelHeight + offset.y;
+	*beginY = std::max(floorDiv(columnX - surface->getWidth() - _spriteWidth, halfWidth), floorDiv(-_spriteHeight - columnY, quarterWidth)) + 1;
+	*endY = std::min(ceilDiv(columnX + _spriteWidth, halfWidth), ceilDiv(surface->getHeight() + _spriteHeight - columnY, quarterWidth)) - 1;
+	*beginY = std::max(*beginY, 0);
+	*endY = std::min(*endY, _save->getMapSizeY() - 1);
+}
+
 /**
  * Draw part of unit graphic that overlap current tile.
  * @param surface
@@ -486,15 +537,15 @@ void Map::drawUnit(Surface *surface, Tile *unitTile, Tile *currTile, Position cu
  */
 void Map::drawTerrain(Surface *surface)
 {
+	ProfileTimer timer(PROFILE_TERRAIN);
 	int frameNumber = 0;
 	Surface *tmpSurface;
 	Tile *tile;
-	int beginX = 0, endX = _save->getMapSizeX() - 1;
-	int beginY = 0, endY = _save->getMapSizeY() - 1;
+	int endX = _save->getMapSizeX() - 1;
+	int beginY, endY;
 	int beginZ = 0, endZ = _camera->getShowAllLayers()?_save->getMapSizeZ() - 1:_camera->getViewLevel();
 	Position mapPosition, screenPosition, bulletPositionScreen;
 	int bulletLowX=16000, bulletLowY=16000, bulletLowZ=16000, bulletHighX=0, bulletHighY=0, bulletHighZ=0;
-	int dummy;
 	BattleUnit *unit = 0;
 	int tileShade, wallShade, tileColor, obstacleShade;
 	static const int arrowBob[8] = {0,1,2,1,0,1,2,1};
@@ -601,18 +652,6 @@ void Map::drawTerrain(Surface *surface)
 		}
 	}
 
-	// get corner map coordinates to give rough boundaries in which tiles to redraw are
-	_camera->convertScreenToMap(0, 0, &beginX, &dummy);
-	_camera->convertScreenToMap(surface->getWidth(), 0, &dummy, &beginY);
-	_camera->convertScreenToMap(surface->getWidth() + _spriteWidth, surface->getHeight() + _spriteHeight, &endX, &dummy);
-	_camera->convertScreenToMap(0, surface->getHeight() + _spriteHeight, &dummy, &endY);
-	beginY -= (_camera->getViewLevel() * 2);
-	beginX -= (_camera->getViewLevel() * 2);
-	if (beginX < 0)
-		beginX = 0;
-	if (beginY < 0)
-		beginY = 0;
-
 	bool pathfinderTurnedOn = _save->getPathfinding()->isPathPreviewed();
 
 	if (!_waypoints.empty() || (pathfinderTurnedOn && (_previewSetting & PATH_TU_COST)))
@@ -626,8 +665,9 @@ void Map::drawTerrain(Surface *surface)
 	for (int itZ = beginZ; itZ <= endZ; itZ++)
 	{
 		bool topLayer = itZ == endZ;
-		for (int itX = beginX; itX <= endX; itX++)
+		for (int itX = 0; itX <= endX; itX++)
 		{
+			getVisibleRows(surface, itX, itZ, &beginY, &endY);
 			for (int itY = beginY; itY <= endY; itY++)
 			{
 				mapPosition = Position(itX, itY, itZ);
@@ -1110,8 +1150,9 @@ void Map::drawTerrain(Surface *surface)
 		}
 		for (int itZ = beginZ; itZ <= endZ; itZ++)
 		{
-			for (int itX = beginX; itX <= endX; itX++)
+			for (int itX = 0; itX <= endX; itX++)
 			{
+				getVisibleRows(surface, itX, itZ, &beginY, &endY);
 				for (int itY = beginY; itY <= endY; itY++)
 				{
 					mapPosition = Position(itX, itY, itZ);
@@ -1535,12 +1576,12 @@ void Map::cacheUnits()
 
 /**
  * Check if a certain unit needs to be redrawn.
+ * The sprites are shared between units that look the same,
+ * so they only get put together once.
  * @param unit Pointer to battleUnit.
  */
 void Map::cacheUnit(BattleUnit *unit)
 {
-	UnitSprite *unitSprite = new UnitSprite(_spriteWidth * 2, _spriteHeight, 0, 0, _save->getDepth() != 0);
-	unitSprite->setPalette(this->getPalette());
 	int numOfParts = unit->getArmor()->getSize() * unit->getArmor()->getSize();
 
 	if (unit->isCacheInvalid())
@@ -1555,17 +1596,11 @@ void Map::cacheUnit(BattleUnit *unit)
 				cache->setPalette(this->getPalette());
 			}
 
-			unitSprite->setBattleUnit(unit, i);
-			unitSprite->setSurfaces(_game->getMod()->getSurfaceSet(unit->getArmor()->getSpriteSheet()),
-									_game->getMod()->getSurfaceSet("HANDOB.PCK"),
-									_game->getMod()->getSurfaceSet("HANDOB2.PCK"));
-			unitSprite->setAnimationFrame(_animFrame);
 			cache->clear();
-			unitSprite->blit(cache);
+			_unitSprites->getSprite(unit, i, _animFrame)->blit(cache);
 			unit->setCache(cache, i);
 		}
 	}
-	delete unitSprite;
 }
 
 /**
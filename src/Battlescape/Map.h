@@ -36,6 +36,7 @@ class Camera;
 class Timer;
 class Text;
 class Tile;
+class UnitSpriteCache;
 
 enum CursorType { CT_NONE, CT_NORMAL, CT_AIM, CT_PSI, CT_WAYPOINT, CT_THROW };
 /**
@@ -68,9 +69,11 @@ private:
 	PathPreview _previewSetting;
 	Text *_txtAccuracy;
 	SurfaceSet *_projectileSet;
+	UnitSpriteCache *_unitSprites;
 
 	void drawUnit(Surface *surface, Tile *unitTile, Tile *currTile, Position tileScreenPosition, int shade, int obstacleShade, bool topLayer);
 	void drawTerrain(Surface *surface);
+	void getVisibleRows(Surface *surface, int x, int z, int *beginY, int *endY) const;
 	int getTerrainLevel(const Position& pos, int size) const;
 	int _iconHeight, _iconWidth, _messageColor;
 	const std::vector<Uint8> *_transparencies;
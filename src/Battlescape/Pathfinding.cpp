@@ -19,12 +19,12 @@
 #include <list>
 #include <algorithm>
 #include "Pathfinding.h"
-#include "PathfindingOpenSet.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Mod/Armor.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "BattlescapeGame.h"
 
 namespace OpenXcom
@@ -38,7 +38,7 @@ int Pathfinding::green = 4;
  * Sets up a Pathfinding.
  * @param save pointer to SavedBattleGame object.
  */
-Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK)
+Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _search(0), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK)
 {
 	_size = _save->getMapSizeXYZ();
 	// Initialize one node per tile
@@ -79,6 +79,7 @@ PathfindingNode *Pathfinding::getNode(Position pos)
  */
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *target, int maxTUCost)
 {
+	ProfileTimer timer(PROFILE_PATHFINDING);
 	_totalTUCost = 0;
 	_path.clear();
 	// i'm DONE with these out of bounds errors.
@@ -191,20 +192,20 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
  */
 bool Pathfinding::aStarPath(Position startPosition, Position endPosition, BattleUnit *target, bool sneak, int maxTUCost)
 {
-	// reset every node, so we have to check them all
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-		it->reset();
+	// start a new search, nodes get reset as we reach them
+	_search++;
+	_openSet.clear();
 
 	// start position is the first one in our "open" list
 	PathfindingNode *start = getNode(startPosition);
+	start->reset(_search);
 	start->connect(0, 0, 0, endPosition);
-	PathfindingOpenSet openList;
-	openList.push(start);
+	_openSet.push(start);
 	bool missile = (target && maxTUCost == 10000);
 	// if the open list is empty, we've reached the end
-	while (!openList.empty())
+	while (!_openSet.empty())
 	{
-		PathfindingNode *currentNode = openList.pop();
+		PathfindingNode *currentNode = _openSet.pop();
 		Position const &currentPos = currentNode->getPosition();
 		currentNode->setChecked();
 		if (currentPos == endPosition) // We found our target.
@@ -228,6 +229,7 @@ bool Pathfinding::aStarPath(Position startPosition, Position endPosition, Battle
 				continue;
 			if (sneak && _save->getTile(nextPos)->getVisible()) tuCost *= 2; // avoid being seen
 			PathfindingNode *nextNode = getNode(nextPos);
+			nextNode->reset(_search);
 			if (nextNode->isChecked()) // Our algorithm means this node is already at minimum cost.
 				continue;
 			_totalTUCost = currentNode->getTUCost(missile) + tuCost;
@@ -235,7 +237,7 @@ bool Pathfinding::aStarPath(Position startPosition, Position endPosition, Battle
 			if ((!nextNode->inOpenSet() || nextNode->getTUCost(missile) > _totalTUCost) && _totalTUCost <= maxTUCost)
 			{
 				nextNode->connect(_totalTUCost, currentNode, direction, endPosition);
-				openList.push(nextNode);
+				_openSet.push(nextNode);
 			}
 		}
 	}
@@ -1157,18 +1159,16 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 {
 	Position start = unit->getPosition();
 	int energyMax = unit->getEnergy();
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-	{
-		it->reset();
-	}
+	_search++;
+	_openSet.clear();
 	PathfindingNode *startNode = getNode(start);
+	startNode->reset(_search);
 	startNode->connect(0, 0, 0);
-	PathfindingOpenSet unvisited;
-	unvisited.push(startNode);
+	_openSet.push(startNode);
 	std::vector<PathfindingNode*> reachable;
-	while (!unvisited.empty())
+	while (!_openSet.empty())
 	{
-		PathfindingNode *currentNode = unvisited.pop();
+		PathfindingNode *currentNode = _openSet.pop();
 		Position const &currentPos = currentNode->getPosition();
 
 		// Try all reachable neighbours.
@@ -1182,6 +1182,7 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 				(currentNode->getTUCost(false) + tuCost) / 2 > energyMax) // Run out of TUs/Energy
 				continue;
 			PathfindingNode *nextNode = getNode(nextPos);
+			nextNode->reset(_search);
 			if (nextNode->isChecked()) // Our algorithm means this node is already at minimum cost.
 				continue;
 			int totalTuCost = currentNode->getTUCost(false) + tuCost;
@@ -1189,7 +1190,7 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 			if (!nextNode->inOpenSet() || nextNode->getTUCost(false) > totalTuCost)
 			{
 				nextNode->connect(totalTuCost, currentNode, direction);
-				unvisited.push(nextNode);
+				_openSet.push(nextNode);
 			}
 		}
 		currentNode->setChecked();
@@ -20,6 +20,7 @@
 #include <vector>
 #include "Position.h"
 #include "PathfindingNode.h"
+#include "PathfindingOpenSet.h"
 #include "../Mod/MapData.h"
 
 namespace OpenXcom
@@ -37,7 +38,8 @@ class Pathfinding
 private:
 	SavedBattleGame *_save;
 	std::vector<PathfindingNode> _nodes;
-	int _size;
+	PathfindingOpenSet _openSet;
+	int _size, _search;
 	BattleUnit *_unit;
 	bool _pathPreviewed;
 	bool _strafeMove;
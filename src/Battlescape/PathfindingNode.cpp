@@ -26,7 +26,7 @@ namespace OpenXcom
  * Sets up a PathfindingNode.
  * @param pos Position.
  */
-PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _checked(0), _tuCost(0), _prevNode(0), _prevDir(0), _tuGuess(0), _openentry(0)
+PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _checked(0), _tuCost(0), _prevNode(0), _prevDir(0), _tuGuess(0), _search(0), _openIndex(-1)
 {
 
 }
@@ -49,12 +49,18 @@ Position PathfindingNode::getPosition() const
 }
 
 /**
- * Resets the node.
+ * Resets the node the first time a search looks at it,
+ * so the searches don't have to reset every node on the map.
+ * @param search Number of the search.
  */
-void PathfindingNode::reset()
+void PathfindingNode::reset(int search)
 {
-	_checked = false;
-	_openentry = 0;
+	if (_search != search)
+	{
+		_search = search;
+		_checked = false;
+		_openIndex = -1;
+	}
 }
 
 /**
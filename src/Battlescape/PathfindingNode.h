@@ -23,7 +23,6 @@ namespace OpenXcom
 {
 
 class PathfindingOpenSet;
-struct OpenSetEntry;
 
 /**
  * A class that holds pathfinding info for a certain node on the map.
@@ -38,8 +37,10 @@ private:
 	int _prevDir;
 	/// Approximate cost to reach goal position.
 	int _tuGuess;
+	/// Search the node was last reset for.
+	int _search;
 	// Invasive field needed by PathfindingOpenSet
-	OpenSetEntry *_openentry;
+	int _openIndex;
 	friend class PathfindingOpenSet;
 public:
 	/// Creates a new PathfindingNode class.
@@ -48,8 +49,8 @@ public:
 	~PathfindingNode();
 	/// Gets the node position.
 	Position getPosition() const;
-	/// Resets the node.
-	void reset();
+	/// Resets the node for a new search.
+	void reset(int search);
 	/// Is checked?
 	bool isChecked() const;
 	/// Marks the node as checked.
@@ -61,7 +62,7 @@ public:
 	/// Gets the previous walking direction.
 	int getPrevDir() const;
 	/// Is this node already in a PathfindingOpenSet?
-	bool inOpenSet() const { return (_openentry != 0); }
+	bool inOpenSet() const { return (_openIndex >= 0); }
 	/// Gets the approximate cost to reach the target position.
 	int getTUGuess() const { return _tuGuess; }
 
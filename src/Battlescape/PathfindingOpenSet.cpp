@@ -24,66 +24,114 @@ namespace OpenXcom
 {
 
 /**
- * Cleans up all the entries still in set.
+ * Puts an entry at a place in the heap and tells its node.
+ * @param index Place in the heap.
+ * @param entry Entry to put there.
  */
-PathfindingOpenSet::~PathfindingOpenSet()
+void PathfindingOpenSet::place(size_t index, const OpenSetEntry &entry)
 {
-	while (!_queue.empty())
+	_heap[index] = entry;
+	entry._node->_openIndex = (int)index;
+}
+
+/**
+ * Moves an entry up from a place in the heap
+ * until its parent is no more expensive.
+ * @param index Place to start from.
+ * @param entry Entry to move.
+ */
+void PathfindingOpenSet::siftUp(size_t index, const OpenSetEntry &entry)
+{
+	while (index > 0)
+	{
+		size_t parent = (index - 1) / 2;
+		if (_heap[parent]._cost <= entry._cost)
+			break;
+		place(index, _heap[parent]);
+		index = parent;
+	}
+	place(index, entry);
+}
+
+/**
+ * Moves an entry down from a place in the heap
+ * until its children are no cheaper.
+ * @param index Place to start from.
+ * @param entry Entry to move.
+ */
+void PathfindingOpenSet::siftDown(size_t index, const OpenSetEntry &entry)
+{
+	size_t size = _heap.size();
+	for (;;)
 	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
+		size_t child = index * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && _heap[child + 1]._cost < _heap[child]._cost)
+			child++;
+		if (_heap[child]._cost >= entry._cost)
+			break;
+		place(index, _heap[child]);
+		index = child;
 	}
+	place(index, entry);
 }
 
 /**
- * Keeps removing all discarded entries that have come to the top of the queue.
+ * Removes all the nodes from the set,
+ * keeping the memory for the next search.
  */
-void PathfindingOpenSet::removeDiscarded()
+void PathfindingOpenSet::clear()
 {
-	while (!_queue.empty() && !_queue.top()->_node)
+	for (std::vector<OpenSetEntry>::iterator i = _heap.begin(); i != _heap.end(); ++i)
 	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
+		i->_node->_openIndex = -1;
 	}
+	_heap.clear();
 }
 
 /**
- * Gets the node with the least cost.
- * After this call, the node is no longer in the set. It is an error to call this when the set is empty.
- * @return A pointer to the node which had the least cost.
+ * Gets the node with the lowest estimated total cost
+ * and removes it from the set.
+ * @return The next node to check.
  */
 PathfindingNode *PathfindingOpenSet::pop()
 {
 	assert(!empty());
-	OpenSetEntry *entry = _queue.top();
-	PathfindingNode *nd = entry->_node;
-	_queue.pop();
-	delete entry;
-	nd->_openentry = 0;
-
-	// Discarded entries might be visible now.
-	removeDiscarded();
+	PathfindingNode *nd = _heap.front()._node;
+	nd->_openIndex = -1;
+	OpenSetEntry last = _heap.back();
+	_heap.pop_back();
+	if (!_heap.empty())
+	{
+		siftDown(0, last);
+	}
 	return nd;
 }
 
 /**
- * Places the node in the set.
- * If the node was already in the set, the previous entry is discarded.
- * It is the caller's responsibility to never re-add a node with a worse cost.
- * @param node A pointer to the node to add.
+ * Adds a node to the set. If it's already there,
+ * moves it to match its new cost.
+ * @param node Pointer to the node to add.
  */
 void PathfindingOpenSet::push(PathfindingNode *node)
 {
-	OpenSetEntry *entry = new OpenSetEntry;
-	entry->_node = node;
-	entry->_cost = node->getTUCost(false) + node->getTUGuess();
-	if (node->_openentry)
-		node->_openentry->_node = 0;
-	node->_openentry = entry;
-	_queue.push(entry);
+	OpenSetEntry entry;
+	entry._node = node;
+	entry._cost = node->getTUCost(false) + node->getTUGuess();
+	if (node->_openIndex >= 0)
+	{
+		size_t index = node->_openIndex;
+		if (entry._cost < _heap[index]._cost)
+			siftUp(index, entry);
+		else
+			siftDown(index, entry);
+	}
+	else
+	{
+		_heap.push_back(entry);
+		siftUp(_heap.size() - 1, entry);
+	}
 }
 
-
 }
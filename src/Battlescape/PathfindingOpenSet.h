@@ -17,7 +17,8 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <queue>
+#include <cstddef>
+#include <vector>
 
 namespace OpenXcom
 {
@@ -30,44 +31,33 @@ struct OpenSetEntry
 	PathfindingNode *_node;
 };
 
-/**
- * Helper class to compare entries through pointers.
- */
-class EntryCompare
-{
-public:
-	/**
-	 * Compares entries @a *a and @a *b.
-	 * @param a Pointer to first entry.
-	 * @param b Pointer to second entry.
-	 * @return True if entry @a *b must come before @a *a.
-	 */
-	bool operator()(OpenSetEntry *a, OpenSetEntry *b) const
-	{
-		return b->_cost < a->_cost;
-	}
-};
-
 /**
  * A class that holds references to the nodes to be examined in pathfinding.
+ * It's a binary heap ordered by estimated total cost, and every node knows
+ * where it is in the heap, so a node reached by a cheaper path is moved
+ * in place instead of being added again. The storage is kept between searches.
  */
 class PathfindingOpenSet
 {
 public:
-	/// Cleans up the set and frees allocated memory.
-	~PathfindingOpenSet();
 	/// Gets the next node to check.
 	PathfindingNode *pop();
-	/// Adds a node to the set.
+	/// Adds a node to the set, or updates its cost.
 	void push(PathfindingNode *node);
 	/// Is the set empty?
-	bool empty() const { return _queue.empty(); }
+	bool empty() const { return _heap.empty(); }
+	/// Removes all the nodes from the set.
+	void clear();
 
 private:
-	std::priority_queue<OpenSetEntry*, std::vector<OpenSetEntry*>, EntryCompare> _queue;
-
-	/// Removes reachable discarded entries.
-	void removeDiscarded();
+	std::vector<OpenSetEntry> _heap;
+
+	/// Puts an entry at a place in the heap.
+	void place(size_t index, const OpenSetEntry &entry);
+	/// Moves an entry towards the top of the heap.
+	void siftUp(size_t index, const OpenSetEntry &entry);
+	/// Moves an entry towards the bottom of the heap.
+	void siftDown(size_t index, const OpenSetEntry &entry);
 };
 
 }
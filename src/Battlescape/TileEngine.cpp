@@ -18,7 +18,7 @@
  */
 #include <assert.h>
 #include <climits>
-#include <set>
+#include <algorithm>
 #include "TileEngine.h"
 #include <SDL.h>
 #include "AIModule.h"
@@ -39,6 +39,7 @@
 #include "../Mod/Armor.h"
 #include "Pathfinding.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "ProjectileFlyBState.h"
 #include "MeleeAttackBState.h"
 #include "../fmath.h"
@@ -48,12 +49,159 @@ namespace OpenXcom
 
 const int TileEngine::heightFromCenter[11] = {0,-2,+2,-4,+4,-6,+6,-8,+8,-12,+12};
 
+/**
+ * Sines and cosines of the angles explosion rays are cast at,
+ * every 5 degrees vertically and 3 degrees horizontally,
+ * so they don't have to be worked out for every blast.
+ */
+struct ExplosionRays
+{
+	static const int FI_STEPS = 37, TE_STEPS = 121;
+	double sinFi[FI_STEPS], cosFi[FI_STEPS], sinTe[TE_STEPS], cosTe[TE_STEPS];
+	ExplosionRays()
+	{
+		for (int i = 0; i < FI_STEPS; ++i)
+		{
+			int fi = i * 5 - 90;
+			sinFi[i] = sin(Deg2Rad(fi));
+			cosFi[i] = cos(Deg2Rad(fi));
+		}
+		for (int i = 0; i < TE_STEPS; ++i)
+		{
+			int te = i * 3;
+			sinTe[i] = sin(Deg2Rad(te));
+			cosTe[i] = cos(Deg2Rad(te));
+		}
+	}
+};
+static const ExplosionRays explosionRays;
+
+/**
+ * Steps through the voxels of a line using bresenham algorithm in 3D,
+ * one voxel per call. Besides the voxel on each step of the longest
+ * axis, it also visits the intermediate voxels of diagonal steps,
+ * so nothing can slip through the corners.
+ */
+class LineStepper
+{
+private:
+	int _x, _y, _z, _x1;
+	int _deltaX, _deltaY, _deltaZ;
+	int _stepX, _stepY, _stepZ;
+	int _driftXY, _driftXZ;
+	bool _swapXY, _swapXZ;
+	int _stage;
+	/// Gets the current voxel in the real axes.
+	Position current() const
+	{
+		Position voxel(_x, _y, _z);
+		//unswap (in reverse)
+		if (_swapXZ) std::swap(voxel.x, voxel.z);
+		if (_swapXY) std::swap(voxel.x, voxel.y);
+		return voxel;
+	}
+public:
+	/// Sets up a line between two voxels.
+	LineStepper(Position origin, Position target) : _stage(0)
+	{
+		int x0 = origin.x, x1 = target.x;
+		int y0 = origin.y, y1 = target.y;
+		int z0 = origin.z, z1 = target.z;
+
+		//'steep' xy Line, make longest delta x plane
+		_swapXY = abs(y1 - y0) > abs(x1 - x0);
+		if (_swapXY)
+		{
+			std::swap(x0, y0);
+			std::swap(x1, y1);
+		}
+
+		//do same for xz
+		_swapXZ = abs(z1 - z0) > abs(x1 - x0);
+		if (_swapXZ)
+		{
+			std::swap(x0, z0);
+			std::swap(x1, z1);
+		}
+
+		//delta is Length in each plane
+		_deltaX = abs(x1 - x0);
+		_deltaY = abs(y1 - y0);
+		_deltaZ = abs(z1 - z0);
+
+		//drift controls when to step in 'shallow' planes
+		//starting value keeps Line centred
+		_driftXY = _deltaX / 2;
+		_driftXZ = _deltaX / 2;
+
+		//direction of line
+		_stepX = (x0 > x1) ? -1 : 1;
+		_stepY = (y0 > y1) ? -1 : 1;
+		_stepZ = (z0 > z1) ? -1 : 1;
+
+		_x = x0;
+		_y = y0;
+		_z = z0;
+		_x1 = x1;
+	}
+	/**
+	 * Moves on to the next voxel of the line.
+	 * @param voxel Returns the voxel.
+	 * @param diagonal Returns if it's an intermediate voxel of a diagonal step.
+	 * @return False once past the end of the line.
+	 */
+	bool next(Position &voxel, bool &diagonal)
+	{
+		for (;;)
+		{
+			switch (_stage)
+			{
+			case 0: // step of the longest delta (which we have swapped to x)
+				voxel = current();
+				diagonal = false;
+				_stage = (_x == _x1) ? 4 : 1;
+				return true;
+			case 1: // update progress in other planes, then step in y plane
+				_driftXY -= _deltaY;
+				_driftXZ -= _deltaZ;
+				_stage = 2;
+				if (_driftXY < 0)
+				{
+					_y += _stepY;
+					_driftXY += _deltaX;
+					voxel = current();
+					diagonal = true;
+					return true;
+				}
+				break;
+			case 2: // same in z
+				_stage = 3;
+				if (_driftXZ < 0)
+				{
+					_z += _stepZ;
+					_driftXZ += _deltaX;
+					voxel = current();
+					diagonal = true;
+					return true;
+				}
+				break;
+			case 3:
+				_x += _stepX;
+				_stage = 0;
+				break;
+			default:
+				return false;
+			}
+		}
+	}
+};
+
 /**
  * Sets up a TileEngine.
  * @param save Pointer to SavedBattleGame object.
  * @param voxelData List of voxel data.
  */
-TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _personalLighting(true), _cacheTile(0), _cacheTileBelow(0)
+TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _voxelGrid(voxelData, save->getMapSizeXYZ()), _personalLighting(true), _cacheTile(0), _cacheTileBelow(0), _explosionNumber(0), _reactorSide(-1), _reactorCount(0)
 {
 	_cacheTilePos = Position(-1,-1,-1);
 }
@@ -71,6 +219,7 @@ TileEngine::~TileEngine()
   */
 void TileEngine::calculateSunShading()
 {
+	ProfileTimer timer(PROFILE_LIGHTING);
 	const int layer = 0; // Ambient lighting layer.
 
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
@@ -115,6 +264,7 @@ void TileEngine::calculateSunShading(Tile *tile)
   */
 void TileEngine::calculateTerrainLighting()
 {
+	ProfileTimer timer(PROFILE_LIGHTING);
 	const int layer = 1; // Static lighting layer.
 	const int fireLightPower = 15; // amount of light a fire generates
 
@@ -157,11 +307,116 @@ void TileEngine::calculateTerrainLighting()
 
 }
 
+/**
+ * Counts the marked map columns inside a rectangle, clipped to the map.
+ * @param marked Summed area table of the marked columns.
+ * @param sizeX Width of the map.
+ * @param sizeY Length of the map.
+ * @param x1 Left edge.
+ * @param y1 Top edge.
+ * @param x2 Right edge.
+ * @param y2 Bottom edge.
+ * @return Number of marked columns.
+ */
+static int countMarked(const std::vector<int> &marked, int sizeX, int sizeY, int x1, int y1, int x2, int y2)
+{
+	x1 = std::max(x1, 0);
+	y1 = std::max(y1, 0);
+	x2 = std::min(x2, sizeX - 1);
+	y2 = std::min(y2, sizeY - 1);
+	if (x1 > x2 || y1 > y2)
+		return 0;
+	int w = sizeX + 1;
+	return marked[(y2 + 1) * w + x2 + 1] - marked[y1 * w + x2 + 1] - marked[(y2 + 1) * w + x1] + marked[y1 * w + x1];
+}
+
+/**
+ * Recalculates the terrain lighting only around the positions where
+ * light sources have appeared or disappeared. Every light source that
+ * reaches that area is added again, so the result is the same as
+ * recalculating the whole map.
+ * @param changes Positions of the changed light sources.
+ * @param power Strongest terrain light that may have changed (fires are always covered).
+ */
+void TileEngine::calculateTerrainLighting(const std::vector<Position> &changes, int power)
+{
+	ProfileTimer timer(PROFILE_LIGHTING);
+	const int layer = 1; // Static lighting layer.
+	const int fireLightPower = 15; // amount of light a fire generates
+
+	if (changes.empty())
+		return;
+	power = std::max(power, fireLightPower);
+
+	// mark the map columns the changes could have lit, light doesn't care about height
+	int sizeX = _save->getMapSizeX(), sizeY = _save->getMapSizeY();
+	int w = sizeX + 1;
+	std::vector<int> marked(w * (sizeY + 1), 0);
+	for (std::vector<Position>::const_iterator i = changes.begin(); i != changes.end(); ++i)
+	{
+		for (int y = std::max(i->y - power, 0); y <= std::min(i->y + power, sizeY - 1); ++y)
+		{
+			for (int x = std::max(i->x - power, 0); x <= std::min(i->x + power, sizeX - 1); ++x)
+			{
+				marked[(y + 1) * w + x + 1] = 1;
+			}
+		}
+	}
+	for (int y = 1; y <= sizeY; ++y)
+	{
+		for (int x = 1; x <= sizeX; ++x)
+		{
+			marked[y * w + x] += marked[(y - 1) * w + x] + marked[y * w + x - 1] - marked[(y - 1) * w + x - 1];
+		}
+	}
+
+	// reset the light in those columns
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		Tile *tile = _save->getTiles()[i];
+		const Position &pos = tile->getPosition();
+		if (countMarked(marked, sizeX, sizeY, pos.x, pos.y, pos.x, pos.y))
+		{
+			tile->resetLight(layer);
+		}
+	}
+
+	// and add back every light that reaches them
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		Tile *tile = _save->getTiles()[i];
+		const Position &pos = tile->getPosition();
+		int lights[3] = { 0, 0, 0 };
+		if (tile->getMapData(O_FLOOR))
+			lights[0] = tile->getMapData(O_FLOOR)->getLightSource();
+		if (tile->getMapData(O_OBJECT))
+			lights[1] = tile->getMapData(O_OBJECT)->getLightSource();
+		if (tile->getFire())
+			lights[2] = fireLightPower;
+		for (int j = 0; j < 3; ++j)
+		{
+			if (lights[j] && countMarked(marked, sizeX, sizeY, pos.x - lights[j], pos.y - lights[j], pos.x + lights[j], pos.y + lights[j]))
+			{
+				addLight(pos, lights[j], layer);
+			}
+		}
+		for (std::vector<BattleItem*>::iterator it = tile->getInventory()->begin(); it != tile->getInventory()->end(); ++it)
+		{
+			int flare = (*it)->getRules()->getPower();
+			if ((*it)->getRules()->getBattleType() == BT_FLARE && countMarked(marked, sizeX, sizeY, pos.x - flare, pos.y - flare, pos.x + flare, pos.y + flare))
+			{
+				addLight(pos, flare, layer);
+			}
+		}
+	}
+}
+
 /**
   * Recalculates lighting for the units.
   */
 void TileEngine::calculateUnitLighting()
 {
+	ProfileTimer timer(PROFILE_LIGHTING);
 	const int layer = 2; // Dynamic lighting layer.
 	const int personalLightPower = 15; // amount of light a unit generates
 	const int fireLightPower = 15; // amount of light a fire generates
@@ -227,6 +482,7 @@ void TileEngine::addLight(Position center, int power, int layer)
  */
 bool TileEngine::calculateFOV(BattleUnit *unit)
 {
+	ProfileTimer timer(PROFILE_FOV);
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	Position center = unit->getPosition();
 	Position test;
@@ -384,6 +640,26 @@ Position TileEngine::getSightOriginVoxel(BattleUnit *currentUnit)
 	return originVoxel;
 }
 
+/**
+ * Checks if a unit is close enough to be seen, and for xcom, if
+ * there is enough light to see it. This is the cheap part of visible().
+ * @param currentUnit The watcher.
+ * @param tile The tile to check for.
+ * @return True if the tile is in visual range.
+ */
+bool TileEngine::inVisualRange(BattleUnit *currentUnit, Tile *tile) const
+{
+	// aliens can see in the dark, xcom can see at a distance of 9 or less, further if there's enough light.
+	if ((currentUnit->getFaction() == FACTION_PLAYER &&
+		distance(currentUnit->getPosition(), tile->getPosition()) > 9 &&
+		tile->getShade() > MAX_DARKNESS_TO_SEE_UNITS) ||
+		distance(currentUnit->getPosition(), tile->getPosition()) > MAX_VIEW_DISTANCE)
+	{
+		return false;
+	}
+	return true;
+}
+
 /**
  * Checks for an opposing unit on this tile.
  * @param currentUnit The watcher.
@@ -398,11 +674,7 @@ bool TileEngine::visible(BattleUnit *currentUnit, Tile *tile)
 		return false;
 	}
 
-	// aliens can see in the dark, xcom can see at a distance of 9 or less, further if there's enough light.
-	if ((currentUnit->getFaction() == FACTION_PLAYER &&
-		distance(currentUnit->getPosition(), tile->getPosition()) > 9 &&
-		tile->getShade() > MAX_DARKNESS_TO_SEE_UNITS) ||
-		distance(currentUnit->getPosition(), tile->getPosition()) > MAX_VIEW_DISTANCE)
+	if (!inVisualRange(currentUnit, tile))
 	{
 		return false;
 	}
@@ -461,7 +733,7 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 {
 	Position targetVoxel = Position((tile->getPosition().x * 16) + 7, (tile->getPosition().y * 16) + 8, tile->getPosition().z * 24);
 	Position scanVoxel;
-	std::vector<Position> _trajectory;
+	std::vector<VoxelRay> rays;
 	BattleUnit *otherUnit = tile->getUnit();
 	if (otherUnit == 0) return 0; //no unit in this tile, even if it elevated and appearing in it.
 	if (otherUnit == excludeUnit) return 0; //skip self
@@ -508,19 +780,18 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 		{
 			scanVoxel.x=targetVoxel.x + sliceTargets[j*2];
 			scanVoxel.y=targetVoxel.y + sliceTargets[j*2+1];
-			_trajectory.clear();
-			int test = calculateLine(*originVoxel, scanVoxel, false, &_trajectory, excludeUnit, true, false, excludeAllBut);
-			if (test == V_UNIT)
-			{
-				//voxel of hit must be inside of scanned box
-				if (_trajectory.at(0).x/16 == scanVoxel.x/16 &&
-					_trajectory.at(0).y/16 == scanVoxel.y/16 &&
-					_trajectory.at(0).z >= targetMinHeight &&
-					_trajectory.at(0).z <= targetMaxHeight)
-				{
-					++visible;
-				}
-			}
+			//voxel of hit must be inside of scanned box
+			Position boxMin = Position((scanVoxel.x/16) * 16, (scanVoxel.y/16) * 16, targetMinHeight);
+			Position boxMax = Position(boxMin.x + 15, boxMin.y + 15, targetMaxHeight);
+			rays.push_back(VoxelRay(scanVoxel, boxMin, boxMax));
+		}
+	}
+	traceRays(*originVoxel, rays, V_UNIT, false, excludeUnit, excludeAllBut);
+	for (std::vector<VoxelRay>::const_iterator i = rays.begin(); i != rays.end(); ++i)
+	{
+		if (i->hit)
+		{
+			++visible;
 		}
 	}
 	return (visible*100)/total;
@@ -539,8 +810,7 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scanVoxel, BattleUnit *excludeUnit, bool rememberObstacles, BattleUnit *potentialUnit)
 {
 	Position targetVoxel = Position((tile->getPosition().x * 16) + 7, (tile->getPosition().y * 16) + 8, tile->getPosition().z * 24);
-	std::vector<Position> _trajectory;
-	bool hypothetical = potentialUnit != 0;
+	std::vector<VoxelRay> rays;
 	if (potentialUnit == 0)
 	{
 		potentialUnit = tile->getUnit();
@@ -597,34 +867,25 @@ bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scan
 			if (i < (heightRange-1) && j>2) break; //skip unnecessary checks
 			scanVoxel->x=targetVoxel.x + sliceTargets[j*2];
 			scanVoxel->y=targetVoxel.y + sliceTargets[j*2+1];
-			_trajectory.clear();
-			int test = calculateLine(*originVoxel, *scanVoxel, false, &_trajectory, excludeUnit, true, false);
-			if (test == V_UNIT)
-			{
-				for (int x = 0; x <= targetSize; ++x)
-				{
-					for (int y = 0; y <= targetSize; ++y)
-					{
-						//voxel of hit must be inside of scanned box
-						if (_trajectory.at(0).x/16 == (scanVoxel->x/16) + x + xOffset &&
-							_trajectory.at(0).y/16 == (scanVoxel->y/16) + y + yOffset &&
-							_trajectory.at(0).z >= targetMinHeight &&
-							_trajectory.at(0).z <= targetMaxHeight)
-						{
-							return true;
-						}
-					}
-				}
-			}
-			else if (test == V_EMPTY && hypothetical && !_trajectory.empty())
-			{
-				return true;
-			}
-			if (rememberObstacles && _trajectory.size()>0)
-			{
-				Tile *tileObstacle = _save->getTile(Position(_trajectory.at(0).x / 16, _trajectory.at(0).y / 16, _trajectory.at(0).z / 24));
-				if (tileObstacle) tileObstacle->setObstacle(test);
-			}
+			//voxel of hit must be inside of scanned box, which covers all of a large unit
+			Position boxMin = Position(((scanVoxel->x/16) + xOffset) * 16, ((scanVoxel->y/16) + yOffset) * 16, targetMinHeight);
+			Position boxMax = Position(boxMin.x + (targetSize + 1) * 16 - 1, boxMin.y + (targetSize + 1) * 16 - 1, targetMaxHeight);
+			rays.push_back(VoxelRay(*scanVoxel, boxMin, boxMax));
+		}
+	}
+
+	size_t traced = traceRays(*originVoxel, rays, V_UNIT, true, excludeUnit);
+	for (size_t i = 0; i < traced; ++i)
+	{
+		if (rays[i].hit)
+		{
+			*scanVoxel = rays[i].target;
+			return true;
+		}
+		if (rememberObstacles && rays[i].result != V_EMPTY)
+		{
+			Tile *tileObstacle = _save->getTile(Position(rays[i].impact.x / 16, rays[i].impact.y / 16, rays[i].impact.z / 24));
+			if (tileObstacle) tileObstacle->setObstacle(rays[i].result);
 		}
 	}
 	return false;
@@ -649,7 +910,7 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
 	static int northWallSpiral[14] = {7,0, 9,0, 6,0, 11,0, 4,0, 13,0, 2,0};
 
 	Position targetVoxel = Position((tile->getPosition().x * 16), (tile->getPosition().y * 16), tile->getPosition().z * 24);
-	std::vector<Position> _trajectory;
+	std::vector<VoxelRay> rays;
 
 	int *spiralArray;
 	int spiralCount;
@@ -782,22 +1043,26 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
 		{
 			scanVoxel->x = targetVoxel.x + spiralArray[i*2];
 			scanVoxel->y = targetVoxel.y + spiralArray[i*2+1];
-			_trajectory.clear();
-			int test = calculateLine(*originVoxel, *scanVoxel, false, &_trajectory, excludeUnit, true);
-			if (test == part && !dummy) //bingo
-			{
-				if (_trajectory.at(0).x/16 == scanVoxel->x/16 &&
-					_trajectory.at(0).y/16 == scanVoxel->y/16 &&
-					_trajectory.at(0).z/24 == scanVoxel->z/24)
-				{
-					return true;
-				}
-			}
-			if (rememberObstacles && _trajectory.size()>0)
-			{
-				Tile *tileObstacle = _save->getTile(Position(_trajectory.at(0).x / 16, _trajectory.at(0).y / 16, _trajectory.at(0).z / 24));
-				if (tileObstacle) tileObstacle->setObstacle(test);
-			}
+			// the hit must be on the tile we're aiming at
+			Position boxMin = Position((scanVoxel->x/16) * 16, (scanVoxel->y/16) * 16, (scanVoxel->z/24) * 24);
+			Position boxMax = boxMin + Position(15, 15, 23);
+			rays.push_back(VoxelRay(*scanVoxel, boxMin, boxMax));
+		}
+	}
+
+	// a dummy attempt never hits
+	size_t traced = traceRays(*originVoxel, rays, dummy ? (int)V_EMPTY : part, true, excludeUnit);
+	for (size_t i = 0; i < traced; ++i)
+	{
+		if (rays[i].hit) //bingo
+		{
+			*scanVoxel = rays[i].target;
+			return true;
+		}
+		if (rememberObstacles && rays[i].result != V_EMPTY)
+		{
+			Tile *tileObstacle = _save->getTile(Position(rays[i].impact.x / 16, rays[i].impact.y / 16, rays[i].impact.z / 24));
+			if (tileObstacle) tileObstacle->setObstacle(rays[i].result);
 		}
 	}
 	return false;
@@ -882,7 +1147,8 @@ std::vector<std::pair<BattleUnit *, int> > TileEngine::getSpottingUnits(BattleUn
 	// no reaction on civilian turn.
 	if (_save->getSide() != FACTION_NEUTRAL)
 	{
-		for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+		const std::vector<BattleUnit*> &reactors = getReactors();
+		for (std::vector<BattleUnit*>::const_iterator i = reactors.begin(); i != reactors.end(); ++i)
 		{
 				// not dead/unconscious
 			if (!(*i)->isOut() &&
@@ -895,7 +1161,9 @@ std::vector<std::pair<BattleUnit *, int> > TileEngine::getSpottingUnits(BattleUn
 				// not a civilian
 				(*i)->getFaction() != FACTION_NEUTRAL &&
 				// closer than 20 tiles
-				distanceSq(unit->getPosition(), (*i)->getPosition()) <= MAX_VIEW_DISTANCE_SQR)
+				distanceSq(unit->getPosition(), (*i)->getPosition()) <= MAX_VIEW_DISTANCE_SQR &&
+				// close enough to see, and not too dark
+				inVisualRange(*i, tile))
 			{
 				BattleAction falseAction;
 				falseAction.type = BA_SNAPSHOT;
@@ -946,17 +1214,42 @@ std::vector<std::pair<BattleUnit *, int> > TileEngine::getSpottingUnits(BattleUn
 	return spotters;
 }
 
+/**
+ * Gets the units that could react to the side whose turn it is, which
+ * are the units of the other sides except civilians. The list only
+ * changes when the turn passes or units are added to the battle, so it
+ * is kept until then and the reactors are checked for state on use.
+ * @return A vector of potential reactors, in the same order as the unit list.
+ */
+const std::vector<BattleUnit*> &TileEngine::getReactors()
+{
+	if (_reactorSide != _save->getSide() || _reactorCount != _save->getUnits()->size())
+	{
+		_reactorSide = _save->getSide();
+		_reactorCount = _save->getUnits()->size();
+		_reactors.clear();
+		for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+		{
+			if ((*i)->getFaction() != _save->getSide() && (*i)->getFaction() != FACTION_NEUTRAL)
+			{
+				_reactors.push_back(*i);
+			}
+		}
+	}
+	return _reactors;
+}
+
 /**
  * Gets the unit with the highest reaction score from the spotter vector.
  * @param spotters The vector of spotting units.
  * @param unit The unit to check scores against.
  * @return The unit with the highest reactions.
  */
-BattleUnit* TileEngine::getReactor(std::vector<std::pair<BattleUnit *, int> > spotters, int &attackType, BattleUnit *unit)
+BattleUnit* TileEngine::getReactor(const std::vector<std::pair<BattleUnit *, int> > &spotters, int &attackType, BattleUnit *unit)
 {
 	int bestScore = -1;
 	BattleUnit *bu = 0;
-	for (std::vector<std::pair<BattleUnit *, int> >::iterator i = spotters.begin(); i != spotters.end(); ++i)
+	for (std::vector<std::pair<BattleUnit *, int> >::const_iterator i = spotters.begin(); i != spotters.end(); ++i)
 	{
 		if (!(*i).first->isOut() &&
 		!(*i).first->getRespawn() &&
@@ -1210,14 +1503,21 @@ BattleUnit *TileEngine::hit(Position center, int power, ItemDamageType type, Bat
  */
 void TileEngine::explode(Position center, int power, ItemDamageType type, int maxRadius, BattleUnit *unit)
 {
+	ProfileTimer timer(PROFILE_EXPLODE);
 	double centerZ = center.z / 24 + 0.5;
 	double centerX = center.x / 16 + 0.5;
 	double centerY = center.y / 16 + 0.5;
 	int hitSide = 0;
 	int diagonalWall = 0;
 	int power_;
-	std::set<Tile*> tilesAffected;
-	std::pair<std::set<Tile*>::iterator,bool> ret;
+	std::vector<Tile*> tilesAffected;
+
+	// tiles are marked with the current explosion's number the first time a ray reaches them
+	if (_explosionVisits.size() != (size_t)_save->getMapSizeXYZ() || ++_explosionNumber == 0)
+	{
+		_explosionVisits.assign(_save->getMapSizeXYZ(), 0);
+		_explosionNumber = 1;
+	}
 
 	if (type == DT_IN)
 	{
@@ -1251,15 +1551,16 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 			hitSide = (center.x % 16 + center.y % 16 - 15) > 0 ? 1 : -1;
 	}
 
-	for (int fi = -90; fi <= 90; fi += 5)
+	for (int i = 0; i < ExplosionRays::FI_STEPS; ++i)
 	{
 		// raytrace every 3 degrees makes sure we cover all tiles in a circle.
-		for (int te = 0; te <= 360; te += 3)
+		for (int j = 0; j < ExplosionRays::TE_STEPS; ++j)
 		{
-			double cos_te = cos(Deg2Rad(te));
-			double sin_te = sin(Deg2Rad(te));
-			double sin_fi = sin(Deg2Rad(fi));
-			double cos_fi = cos(Deg2Rad(fi));
+			int te = j * 3;
+			double cos_te = explosionRays.cosTe[j];
+			double sin_te = explosionRays.sinTe[j];
+			double sin_fi = explosionRays.sinFi[i];
+			double cos_fi = explosionRays.cosFi[i];
 
 			origin = _save->getTile(Position(centerX, centerY, centerZ));
 			dest = origin;
@@ -1276,9 +1577,11 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 						dest->setExplosive(power_, 0);
 					}
 
-					ret = tilesAffected.insert(dest); // check if we had this tile already
-					if (ret.second)
+					unsigned int &visit = _explosionVisits[_save->getTileIndex(dest->getPosition())];
+					if (visit != _explosionNumber) // check if we had this tile already
 					{
+						visit = _explosionNumber;
+						tilesAffected.push_back(dest);
 						int min = power_ * (100 - dmgRng) / 100;
 						int max = power_ * (100 + dmgRng) / 100;
 						BattleUnit *bu = dest->getUnit();
@@ -1464,7 +1767,9 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 
 	if (type == DT_HE)
 	{
-		for (std::set<Tile*>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
+		// same order as they've always been detonated in
+		std::sort(tilesAffected.begin(), tilesAffected.end());
+		for (std::vector<Tile*>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
 		{
 			if (detonate(*i))
 			{
@@ -2224,171 +2529,133 @@ int TileEngine::closeUfoDoors()
  */
 int TileEngine::calculateLine(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, bool doVoxelCheck, bool onlyVisible, BattleUnit *excludeAllBut)
 {
-	int x, x0, x1, delta_x, step_x;
-	int y, y0, y1, delta_y, step_y;
-	int z, z0, z1, delta_z, step_z;
-	int swap_xy, swap_xz;
-	int drift_xy, drift_xz;
-	int cx, cy, cz;
-	Position lastPoint(origin);
 	int result;
-	int steps = 0;
-	bool excludeAllUnits = false;
-	if (_save->isBeforeGame())
+	if (doVoxelCheck)
 	{
-		excludeAllUnits = true; // don't start unit spotting before pre-game inventory stuff (large units on the craftInventory tile will cause a crash if they're "spotted")
-	}
-
-	//start and end points
-	x0 = origin.x;	 x1 = target.x;
-	y0 = origin.y;	 y1 = target.y;
-	z0 = origin.z;	 z1 = target.z;
-
-	//'steep' xy Line, make longest delta x plane
-	swap_xy = abs(y1 - y0) > abs(x1 - x0);
-	if (swap_xy)
-	{
-		std::swap(x0, y0);
-		std::swap(x1, y1);
-	}
-
-	//do same for xz
-	swap_xz = abs(z1 - z0) > abs(x1 - x0);
-	if (swap_xz)
-	{
-		std::swap(x0, z0);
-		std::swap(x1, z1);
+		bool excludeAllUnits = false;
+		if (_save->isBeforeGame())
+		{
+			excludeAllUnits = true; // don't start unit spotting before pre-game inventory stuff (large units on the craftInventory tile will cause a crash if they're "spotted")
+		}
+		voxelCheckFlush();
+		Position impact;
+		result = traceLine(origin, target, &impact, excludeUnit, excludeAllUnits, onlyVisible, excludeAllBut, storeTrajectory ? trajectory : 0);
+		if (result != V_EMPTY && trajectory)
+		{ // store the position of impact
+			trajectory->push_back(impact);
+		}
+		return result;
 	}
 
-	//delta is Length in each plane
-	delta_x = abs(x1 - x0);
-	delta_y = abs(y1 - y0);
-	delta_z = abs(z1 - z0);
-
-	//drift controls when to step in 'shallow' planes
-	//starting value keeps Line centred
-	drift_xy  = (delta_x / 2);
-	drift_xz  = (delta_x / 2);
-
-	//direction of line
-	step_x = 1;  if (x0 > x1) {  step_x = -1; }
-	step_y = 1;  if (y0 > y1) {  step_y = -1; }
-	step_z = 1;  if (z0 > z1) {  step_z = -1; }
-
-	//starting point
-	y = y0;
-	z = z0;
-
-	if (doVoxelCheck) voxelCheckFlush();
-
-	//step through longest delta (which we have swapped to x)
-	for (x = x0;; x += step_x)
+	Position lastPoint(origin);
+	int steps = 0;
+	LineStepper line(origin, target);
+	Position point;
+	bool diagonal;
+	while (line.next(point, diagonal))
 	{
-		//copy position
-		cx = x;	cy = y;	cz = z;
-
-		//unswap (in reverse)
-		if (swap_xz) std::swap(cx, cz);
-		if (swap_xy) std::swap(cx, cy);
+		// tile blocking only cares about the steps of the longest delta
+		if (diagonal) continue;
 
 		if (storeTrajectory && trajectory)
 		{
-			trajectory->push_back(Position(cx, cy, cz));
+			trajectory->push_back(point);
 		}
 		//passes through this point?
-		if (doVoxelCheck)
+		int temp_res = verticalBlockage(_save->getTile(lastPoint), _save->getTile(point), DT_NONE);
+		result = horizontalBlockage(_save->getTile(lastPoint), _save->getTile(point), DT_NONE, steps<2);
+		steps++;
+		if (result == -1)
 		{
-			result = voxelCheck(Position(cx, cy, cz), excludeUnit, false, onlyVisible, excludeAllBut);
-			if (result != V_EMPTY)
+			if (temp_res > 127)
 			{
-				if (trajectory)
-				{ // store the position of impact
-					trajectory->push_back(Position(cx, cy, cz));
-				}
-				return result;
+				result = 0;
+			} else {
+			return result; // We hit a big wall
 			}
 		}
-		else
+		result += temp_res;
+		if (result > 127)
 		{
-			int temp_res = verticalBlockage(_save->getTile(lastPoint), _save->getTile(Position(cx, cy, cz)), DT_NONE);
-			result = horizontalBlockage(_save->getTile(lastPoint), _save->getTile(Position(cx, cy, cz)), DT_NONE, steps<2);
-			steps++;
-			if (result == -1)
-			{
-				if (temp_res > 127)
-				{
-					result = 0;
-				} else {
-				return result; // We hit a big wall
-				}
-			}
-			result += temp_res;
-			if (result > 127)
-			{
-				return result;
-			}
-
-			lastPoint = Position(cx, cy, cz);
+			return result;
 		}
 
-		if (x == x1) break;
+		lastPoint = point;
+	}
 
-		//update progress in other planes
-		drift_xy = drift_xy - delta_y;
-		drift_xz = drift_xz - delta_z;
+	return V_EMPTY;
+}
 
-		//step in y plane
-		if (drift_xy < 0)
+/**
+ * Traces a line through the voxels between two points, stopping at
+ * the first voxel in the way. This is the stepping calculateLine uses
+ * too, so it agrees with where projectiles will go.
+ * Doesn't flush the voxel check cache, so rays sharing an origin
+ * can reuse the tiles already looked up.
+ * @param origin Origin voxel.
+ * @param target Target voxel.
+ * @param impact Returns the voxel hit, if any.
+ * @param excludeUnit Excludes this unit in the collision detection.
+ * @param excludeAllUnits Skip units on the diagonal steps?
+ * @param onlyVisible Skip invisible units?
+ * @param excludeAllBut [Optional] The only unit to be considered for ray hits.
+ * @param trajectory [Optional] Stores the voxel of every step up to the impact.
+ * @return the objectnumber(0-3) or unit(4) or out of map (5) or -1(hit nothing).
+ */
+int TileEngine::traceLine(Position origin, Position target, Position *impact, BattleUnit *excludeUnit, bool excludeAllUnits, bool onlyVisible, BattleUnit *excludeAllBut, std::vector<Position> *trajectory)
+{
+	LineStepper line(origin, target);
+	Position voxel;
+	bool diagonal;
+	while (line.next(voxel, diagonal))
+	{
+		if (trajectory && !diagonal)
 		{
-			y = y + step_y;
-			drift_xy = drift_xy + delta_x;
-
-			//check for xy diagonal intermediate voxel step
-			if (doVoxelCheck)
-			{
-				cx = x;	cz = z; cy = y;
-				if (swap_xz) std::swap(cx, cz);
-				if (swap_xy) std::swap(cx, cy);
-				result = voxelCheck(Position(cx, cy, cz), excludeUnit, excludeAllUnits, onlyVisible, excludeAllBut);
-				if (result != V_EMPTY)
-				{
-					if (trajectory != 0)
-					{ // store the position of impact
-						trajectory->push_back(Position(cx, cy, cz));
-					}
-					return result;
-				}
-			}
+			trajectory->push_back(voxel);
 		}
-
-		//same in z
-		if (drift_xz < 0)
+		int result = voxelCheck(voxel, excludeUnit, diagonal && excludeAllUnits, onlyVisible, excludeAllBut);
+		if (result != V_EMPTY)
 		{
-			z = z + step_z;
-			drift_xz = drift_xz + delta_x;
-
-			//check for xz diagonal intermediate voxel step
-			if (doVoxelCheck)
-			{
-				cx = x;	cz = z; cy = y;
-				if (swap_xz) std::swap(cx, cz);
-				if (swap_xy) std::swap(cx, cy);
-				result = voxelCheck(Position(cx, cy, cz), excludeUnit, excludeAllUnits, onlyVisible,  excludeAllBut);
-				if (result != V_EMPTY)
-				{
-					if (trajectory != 0)
-					{ // store the position of impact
-						trajectory->push_back(Position(cx, cy, cz));
-					}
-					return result;
-				}
-			}
+			*impact = voxel;
+			return result;
 		}
 	}
 
 	return V_EMPTY;
 }
 
+/**
+ * Traces lines of fire from one origin to a batch of targets, in order.
+ * A ray hits when it stops on the given voxel type inside its box.
+ * Nothing is allocated, and the tiles looked up are shared between rays.
+ * @param origin Origin voxel (eye or gun's barrel).
+ * @param rays The rays to trace, which also receive the results.
+ * @param type The voxel type the rays are looking for (V_EMPTY never hits).
+ * @param stopAtHit Stop tracing at the first ray that hits?
+ * @param excludeUnit Excludes this unit in the collision detection.
+ * @param excludeAllBut [Optional] The only unit to be considered for ray hits.
+ * @return Number of rays traced.
+ */
+size_t TileEngine::traceRays(Position origin, std::vector<VoxelRay> &rays, int type, bool stopAtHit, BattleUnit *excludeUnit, BattleUnit *excludeAllBut)
+{
+	bool excludeAllUnits = _save->isBeforeGame();
+	voxelCheckFlush();
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		VoxelRay &ray = rays[i];
+		ray.result = traceLine(origin, ray.target, &ray.impact, excludeUnit, excludeAllUnits, false, excludeAllBut);
+		ray.hit = ray.result != V_EMPTY && ray.result == type &&
+			ray.impact.x >= ray.boxMin.x && ray.impact.x <= ray.boxMax.x &&
+			ray.impact.y >= ray.boxMin.y && ray.impact.y <= ray.boxMax.y &&
+			ray.impact.z >= ray.boxMin.z && ray.impact.z <= ray.boxMax.z;
+		if (ray.hit && stopAtHit)
+		{
+			return i + 1;
+		}
+	}
+	return rays.size();
+}
+
 /**
  * Calculates a parabola trajectory, used for throwing items.
  * @param origin Origin in voxelspace.
@@ -2562,20 +2829,24 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 	}
 
 	// first we check terrain voxel data, not to allow 2x2 units stick through walls
-	for (int i = V_FLOOR; i <= V_OBJECT; ++i)
+	// the voxel grid tells us if any part is there, then we find out which one
+	if (_voxelGrid.isFilled(tile, _save->getTileIndex(pos), voxel.x%16, voxel.y%16, voxel.z%24))
 	{
-		TilePart tp = (TilePart)i;
-		MapData *mp = tile->getMapData(tp);
-		if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
-			continue;
-		if (mp != 0)
+		for (int i = V_FLOOR; i <= V_OBJECT; ++i)
 		{
-			int x = 15 - voxel.x%16;
-			int y = voxel.y%16;
-			int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
-			if (_voxelData->at(idx) & (1 << x))
+			TilePart tp = (TilePart)i;
+			MapData *mp = tile->getMapData(tp);
+			if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
+				continue;
+			if (mp != 0)
 			{
-				return (VoxelType)i;
+				int x = 15 - voxel.x%16;
+				int y = voxel.y%16;
+				int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
+				if (_voxelData->at(idx) & (1 << x))
+				{
+					return (VoxelType)i;
+				}
 			}
 		}
 	}
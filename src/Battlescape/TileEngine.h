@@ -21,6 +21,7 @@
 #include "Position.h"
 #include "../Mod/RuleItem.h"
 #include "../Mod/MapData.h"
+#include "VoxelGrid.h"
 #include <SDL.h>
 
 namespace OpenXcom
@@ -31,6 +32,21 @@ class BattleUnit;
 class BattleItem;
 class Tile;
 struct BattleAction;
+
+/**
+ * A line of fire checked by TileEngine::traceRays.
+ * The ray counts as a hit if it stops on the voxel type
+ * being looked for, inside the box around its target.
+ */
+struct VoxelRay
+{
+	Position target, boxMin, boxMax;
+	Position impact; // first voxel in the way, if any
+	int result;
+	bool hit;
+	VoxelRay(Position target_, Position boxMin_, Position boxMax_) : target(target_), boxMin(boxMin_), boxMax(boxMax_), result(V_EMPTY), hit(false) { }
+};
+
 /**
  * A utility class that modifies tile properties on a battlescape map. This includes lighting, destruction, smoke, fire, fog of war.
  * Note that this function does not handle any sounds or animations.
@@ -43,6 +59,7 @@ private:
 	static const int MAX_VOXEL_VIEW_DISTANCE = MAX_VIEW_DISTANCE * 16;
 	SavedBattleGame *_save;
 	std::vector<Uint16> *_voxelData;
+	VoxelGrid _voxelGrid;
 	static const int heightFromCenter[11];
 	void addLight(Position center, int power, int layer);
 	int blockage(Tile *tile, const TilePart part, ItemDamageType type, int direction = -1, bool checkingFromOrigin = false);
@@ -50,6 +67,17 @@ private:
 	Tile *_cacheTile;
 	Tile *_cacheTileBelow;
 	Position _cacheTilePos;
+	std::vector<unsigned int> _explosionVisits;
+	unsigned int _explosionNumber;
+	std::vector<BattleUnit*> _reactors;
+	int _reactorSide;
+	size_t _reactorCount;
+	/// Gets the units that could react to the side whose turn it is.
+	const std::vector<BattleUnit*> &getReactors();
+	/// Checks if a unit is close enough and lit well enough to be seen.
+	bool inVisualRange(BattleUnit *currentUnit, Tile *tile) const;
+	/// Traces a line through the voxels up to the first one in the way.
+	int traceLine(Position origin, Position target, Position *impact, BattleUnit *excludeUnit, bool excludeAllUnits, bool onlyVisible, BattleUnit *excludeAllBut, std::vector<Position> *trajectory = 0);
 public:
 	static const int MAX_DARKNESS_TO_SEE_UNITS = 9;
 	/// Creates a new TileEngine class.
@@ -68,6 +96,8 @@ public:
 	bool checkReactionFire(BattleUnit *unit);
 	/// Recalculates lighting of the battlescape for terrain.
 	void calculateTerrainLighting();
+	/// Recalculates lighting of the battlescape for terrain around some changes.
+	void calculateTerrainLighting(const std::vector<Position> &changes, int power);
 	/// Recalculates lighting of the battlescape for units.
 	void calculateUnitLighting();
 	/// Handles bullet/weapon hits.
@@ -82,6 +112,8 @@ public:
 	int closeUfoDoors();
 	/// Calculates a line trajectory.
 	int calculateLine(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, bool doVoxelCheck = true, bool onlyVisible = false, BattleUnit *excludeAllBut = 0);
+	/// Traces a batch of lines of fire from the same origin.
+	size_t traceRays(Position origin, std::vector<VoxelRay> &rays, int type, bool stopAtHit, BattleUnit *excludeUnit, BattleUnit *excludeAllBut = 0);
 	/// Calculates a parabola trajectory.
 	int calculateParabola(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, double curvature, const Position delta);
 	/// Gets the origin voxel of a unit's eyesight.
@@ -135,7 +167,7 @@ public:
 	/// Creates a vector of units that can spot this unit.
 	std::vector<std::pair<BattleUnit *, int> > getSpottingUnits(BattleUnit* unit);
 	/// Given a vector of spotters, and a unit, picks the spotter with the highest reaction score.
-	BattleUnit* getReactor(std::vector<std::pair<BattleUnit *, int> > spotters, int &attackType, BattleUnit *unit);
+	BattleUnit* getReactor(const std::vector<std::pair<BattleUnit *, int> > &spotters, int &attackType, BattleUnit *unit);
 	/// Checks validity of a snap shot to this position.
 	int determineReactionType(BattleUnit *unit, BattleUnit *target);
 	/// Tries to perform a reaction snap shot to this location.
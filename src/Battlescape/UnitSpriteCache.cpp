@@ -0,0 +1,237 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "UnitSpriteCache.h"
+#include "UnitSprite.h"
+#include "../Engine/Surface.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Mod/Mod.h"
+#include "../Mod/Armor.h"
+#include "../Mod/RuleItem.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/BattleItem.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Checks if a drawing routine animates on its own,
+ * so the animation frame changes what it draws.
+ * @param routine Drawing routine.
+ * @return True if the animation frame matters.
+ */
+static bool usesAnimationFrame(int routine)
+{
+	switch (routine)
+	{
+	case 0: case 1: case 4: case 5: case 6: case 7: case 10: case 13: case 14: case 17: case 18: case 19: case 20:
+		return false;
+	default:
+		return true;
+	}
+}
+
+/**
+ * Gets the rules of the item a unit shows in one hand.
+ * @param unit Pointer to the unit.
+ * @param slot Hand slot.
+ * @return Item rules, or 0 if nothing is drawn.
+ */
+static const RuleItem *getHandItem(BattleUnit *unit, const std::string &slot)
+{
+	BattleItem *item = unit->getItem(slot);
+	if (item && !item->getRules()->isFixed())
+	{
+		return item->getRules();
+	}
+	return 0;
+}
+
+/**
+ * Builds the key for a part of a unit, from everything
+ * UnitSprite looks at when drawing it.
+ * @param unit Pointer to the unit.
+ * @param part The part number for large units.
+ * @param animationFrame Current animation frame of the map.
+ */
+UnitSpriteKey::UnitSpriteKey(BattleUnit *unit, int part, int animationFrame) : armor(unit->getArmor()), part(part)
+{
+	itemR = getHandItem(unit, "STR_RIGHT_HAND");
+	itemL = getHandItem(unit, "STR_LEFT_HAND");
+	this->animationFrame = usesAnimationFrame(armor->getDrawingRoutine()) ? animationFrame : 0;
+	status = unit->getStatus();
+	direction = unit->getDirection();
+	turretType = unit->getTurretType();
+	turretDirection = unit->getTurretDirection();
+	walkingPhase = unit->getWalkingPhase();
+	fallingPhase = unit->getFallingPhase();
+	standHeight = unit->getStandHeight();
+	gender = unit->getGender();
+	kneeled = unit->isKneeled();
+	floating = unit->isFloating();
+	floorAbove = unit->getFloorAbove();
+	out = unit->isOut();
+	leftHand = unit->getActiveHand() == "STR_LEFT_HAND";
+	if (Options::battleHairBleach)
+	{
+		recolor = unit->getRecolor();
+	}
+}
+
+/**
+ * Orders the keys field by field, for the cache map.
+ * @param other Key to compare with.
+ * @return True if this key comes first.
+ */
+bool UnitSpriteKey::operator<(const UnitSpriteKey &other) const
+{
+	if (armor != other.armor) return armor < other.armor;
+	if (itemR != other.itemR) return itemR < other.itemR;
+	if (itemL != other.itemL) return itemL < other.itemL;
+	if (part != other.part) return part < other.part;
+	if (animationFrame != other.animationFrame) return animationFrame < other.animationFrame;
+	if (status != other.status) return status < other.status;
+	if (direction != other.direction) return direction < other.direction;
+	if (turretType != other.turretType) return turretType < other.turretType;
+	if (turretDirection != other.turretDirection) return turretDirection < other.turretDirection;
+	if (walkingPhase != other.walkingPhase) return walkingPhase < other.walkingPhase;
+	if (fallingPhase != other.fallingPhase) return fallingPhase < other.fallingPhase;
+	if (standHeight != other.standHeight) return standHeight < other.standHeight;
+	if (gender != other.gender) return gender < other.gender;
+	if (kneeled != other.kneeled) return kneeled < other.kneeled;
+	if (floating != other.floating) return floating < other.floating;
+	if (floorAbove != other.floorAbove) return floorAbove < other.floorAbove;
+	if (out != other.out) return out < other.out;
+	if (leftHand != other.leftHand) return leftHand < other.leftHand;
+	return recolor < other.recolor;
+}
+
+/**
+ * Creates an empty cache of unit sprites.
+ * @param mod Pointer to the mod, for the sprite sheets.
+ * @param width Width of the sprites.
+ * @param height Height of the sprites.
+ * @param helmet Draw the helmets of underwater soldiers?
+ */
+UnitSpriteCache::UnitSpriteCache(Mod *mod, int width, int height, bool helmet) : _mod(mod), _palette(0), _width(width), _height(height), _hits(0), _misses(0)
+{
+	_unitSprite = new UnitSprite(width, height, 0, 0, helmet);
+}
+
+/**
+ * Logs how well the cache did and deletes the sprites.
+ */
+UnitSpriteCache::~UnitSpriteCache()
+{
+	if (_hits + _misses != 0)
+	{
+		Log(LOG_DEBUG) << "Unit sprite cache: " << _hits << " hits, " << _misses << " misses, " << _sprites.size() << " sprites using " << getMemoryUsed() / 1024 << " KB.";
+	}
+	clear();
+	delete _unitSprite;
+}
+
+/**
+ * Changes the palette of the sprites. Since they're
+ * blitted onto surfaces with the new palette, the old
+ * sprites are thrown away.
+ * @param colors Pointer to the set of colors.
+ */
+void UnitSpriteCache::setPalette(SDL_Color *colors)
+{
+	clear();
+	_palette = colors;
+	_unitSprite->setPalette(colors);
+}
+
+/**
+ * Gets the composed sprite for a part of a unit,
+ * putting it together the first time it's needed.
+ * @param unit Pointer to the unit.
+ * @param part The part number for large units.
+ * @param animationFrame Current animation frame of the map.
+ * @return Pointer to the sprite.
+ */
+Surface *UnitSpriteCache::getSprite(BattleUnit *unit, int part, int animationFrame)
+{
+	UnitSpriteKey key(unit, part, animationFrame);
+	std::map<UnitSpriteKey, Surface*>::iterator i = _sprites.find(key);
+	if (i != _sprites.end())
+	{
+		_hits++;
+		return i->second;
+	}
+	_misses++;
+	if (_sprites.size() >= MAX_SPRITES)
+	{
+		clear();
+	}
+
+	Surface *sprite = new Surface(_width, _height);
+	sprite->setPalette(_palette);
+	_unitSprite->setBattleUnit(unit, part);
+	_unitSprite->setSurfaces(_mod->getSurfaceSet(unit->getArmor()->getSpriteSheet()),
+							_mod->getSurfaceSet("HANDOB.PCK"),
+							_mod->getSurfaceSet("HANDOB2.PCK"));
+	_unitSprite->setAnimationFrame(animationFrame);
+	_unitSprite->blit(sprite);
+	_sprites[key] = sprite;
+	return sprite;
+}
+
+/**
+ * Deletes all the sprites in the cache.
+ */
+void UnitSpriteCache::clear()
+{
+	for (std::map<UnitSpriteKey, Surface*>::iterator i = _sprites.begin(); i != _sprites.end(); ++i)
+	{
+		delete i->second;
+	}
+	_sprites.clear();
+}
+
+/**
+ * Gets the number of times a sprite was already in the cache.
+ * @return Number of hits.
+ */
+unsigned int UnitSpriteCache::getHits() const
+{
+	return _hits;
+}
+
+/**
+ * Gets the number of times a sprite had to be composed.
+ * @return Number of misses.
+ */
+unsigned int UnitSpriteCache::getMisses() const
+{
+	return _misses;
+}
+
+/**
+ * Gets the memory used by the pixels of the cached sprites.
+ * @return Size in bytes.
+ */
+size_t UnitSpriteCache::getMemoryUsed() const
+{
+	return _sprites.size() * _width * _height;
+}
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <map>
+#include <vector>
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+class Mod;
+class Armor;
+class RuleItem;
+class BattleUnit;
+class Surface;
+class UnitSprite;
+
+/**
+ * Everything about a unit that changes how its sprite looks.
+ * Units that match on all of these get the same sprite.
+ */
+struct UnitSpriteKey
+{
+	const Armor *armor;
+	const RuleItem *itemR, *itemL;
+	int part, animationFrame;
+	int status, direction, turretType, turretDirection, walkingPhase, fallingPhase, standHeight, gender;
+	bool kneeled, floating, floorAbove, out, leftHand;
+	std::vector<std::pair<Uint8, Uint8> > recolor;
+
+	/// Builds the key for a part of a unit.
+	UnitSpriteKey(BattleUnit *unit, int part, int animationFrame);
+	/// Orders keys for the cache.
+	bool operator<(const UnitSpriteKey &other) const;
+};
+
+/**
+ * Shared cache of composed unit sprites for the battlescape,
+ * so a squad in the same armor with the same weapons only has
+ * each frame put together from its parts once.
+ */
+class UnitSpriteCache
+{
+private:
+	static const size_t MAX_SPRITES = 2048;
+	Mod *_mod;
+	UnitSprite *_unitSprite;
+	SDL_Color *_palette;
+	int _width, _height;
+	std::map<UnitSpriteKey, Surface*> _sprites;
+	unsigned int _hits, _misses;
+public:
+	/// Creates an empty unit sprite cache.
+	UnitSpriteCache(Mod *mod, int width, int height, bool helmet);
+	/// Cleans up the unit sprite cache.
+	~UnitSpriteCache();
+	/// Sets the palette for new sprites.
+	void setPalette(SDL_Color *colors);
+	/// Gets the sprite for a part of a unit.
+	Surface *getSprite(BattleUnit *unit, int part, int animationFrame);
+	/// Removes all the sprites.
+	void clear();
+	/// Gets the number of sprites found in the cache.
+	unsigned int getHits() const;
+	/// Gets the number of sprites that had to be composed.
+	unsigned int getMisses() const;
+	/// Gets the memory used by the sprites.
+	size_t getMemoryUsed() const;
+};
+
+}
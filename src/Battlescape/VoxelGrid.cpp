@@ -0,0 +1,116 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "VoxelGrid.h"
+#include <algorithm>
+#include "../Savegame/Tile.h"
+#include "../Mod/MapData.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a voxel grid with every tile still to be built.
+ * @param voxelData Pointer to the LOFTEMPS data.
+ * @param tiles Number of tiles in the map.
+ */
+VoxelGrid::VoxelGrid(const std::vector<Uint16> *voxelData, int tiles) : _voxelData(voxelData), _offsets(tiles, -1), _revisions(tiles, -1)
+{
+}
+
+/**
+ * Cleans up the voxel grid.
+ */
+VoxelGrid::~VoxelGrid()
+{
+}
+
+/**
+ * Merges the voxels of all the solid parts of a tile
+ * into its block, the same way TileEngine::voxelCheck
+ * looks at them. Open ufo doors are left out.
+ * @param tile Pointer to the tile.
+ * @param index Index of the tile in the map.
+ */
+void VoxelGrid::build(const Tile *tile, int index)
+{
+	int offset = _offsets[index];
+	bool empty = true;
+	for (int i = O_FLOOR; i <= O_OBJECT; ++i)
+	{
+		TilePart tp = (TilePart)i;
+		MapData *mp = tile->getMapData(tp);
+		if (mp == 0 || (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp)))
+			continue;
+		if (empty)
+		{
+			empty = false;
+			if (offset < 0)
+			{
+				if (!_free.empty())
+				{
+					offset = _free.back();
+					_free.pop_back();
+				}
+				else
+				{
+					offset = _voxels.size();
+					_voxels.resize(offset + TILE_SIZE);
+				}
+			}
+			std::fill(_voxels.begin() + offset, _voxels.begin() + offset + TILE_SIZE, 0);
+		}
+		for (int layer = 0; layer < LAYERS; ++layer)
+		{
+			int loft = mp->getLoftID(layer) * ROWS;
+			for (int y = 0; y < ROWS; ++y)
+			{
+				_voxels[offset + layer * ROWS + y] |= _voxelData->at(loft + y);
+			}
+		}
+	}
+	if (empty && offset >= 0)
+	{
+		_free.push_back(offset);
+		offset = -1;
+	}
+	_offsets[index] = offset;
+	_revisions[index] = tile->getTerrainRevision();
+}
+
+/**
+ * Checks if a voxel is taken up by any terrain part of a tile,
+ * bringing the tile up to date first if it has changed.
+ * @param tile Pointer to the tile.
+ * @param index Index of the tile in the map.
+ * @param x X voxel inside the tile (0-15).
+ * @param y Y voxel inside the tile (0-15).
+ * @param z Z voxel inside the tile (0-23).
+ * @return True if the voxel is solid terrain.
+ */
+bool VoxelGrid::isFilled(const Tile *tile, int index, int x, int y, int z)
+{
+	if (_revisions[index] != tile->getTerrainRevision())
+	{
+		build(tile, index);
+	}
+	int offset = _offsets[index];
+	return offset >= 0 && (_voxels[offset + (z / 2) * ROWS + y] & (1 << (15 - x))) != 0;
+}
+
+}
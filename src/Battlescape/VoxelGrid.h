@@ -0,0 +1,59 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+class Tile;
+
+/**
+ * Bit-packed terrain occupancy of the battlescape map.
+ * Every tile gets 12 layers of 16 rows of 16 bits, the same
+ * resolution as the LOFTEMPS, with all its terrain parts merged
+ * so a voxel can be tested with a single lookup. Tiles without
+ * any terrain take up no space. Each tile is rebuilt whenever
+ * its terrain revision changes, so destroyed parts and opened
+ * doors are always up to date.
+ */
+class VoxelGrid
+{
+public:
+	static const int LAYERS = 12;
+	static const int ROWS = 16;
+	static const int TILE_SIZE = LAYERS * ROWS;
+private:
+	const std::vector<Uint16> *_voxelData;
+	std::vector<int> _offsets, _revisions, _free;
+	std::vector<Uint16> _voxels;
+
+	/// Rebuilds the occupancy of a tile.
+	void build(const Tile *tile, int index);
+public:
+	/// Creates an empty voxel grid.
+	VoxelGrid(const std::vector<Uint16> *voxelData, int tiles);
+	/// Cleans up the voxel grid.
+	~VoxelGrid();
+	/// Checks if a voxel of a tile is filled with terrain.
+	bool isFilled(const Tile *tile, int index, int x, int y, int z);
+};
+
+}
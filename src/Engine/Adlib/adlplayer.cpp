@@ -151,6 +151,7 @@ int adl_gv_master_music_volume = 127;
 int adl_gv_tmp_music_volume = 127;
 bool adl_gv_want_fade = false;
 bool adl_gv_music_playing = false;
+int adl_gv_loops = 0;
 int adl_gv_tempo = 120;
 int adl_gv_tempo_run = 60;
 int adl_gv_tempo_inc = 70;
@@ -817,6 +818,7 @@ void func_play_tick()
 			--instruments[instr].cur_delay;
 		}
 		if (!another_loop && adl_gv_music_playing) break;
+		if (another_loop) ++adl_gv_loops;
 		init_music();
 		clear_channels();
 	} while (another_loop);
@@ -829,6 +831,7 @@ void func_setup_music(unsigned char* music_ptr, int length)
 	func_mute();
 	adl_gv_polyphony_level = 0;
 	adl_gv_want_fade = false;
+	adl_gv_loops = 0;
 	adl_gv_tmp_music_volume = adl_gv_master_music_volume;
 	init_music_data(music_ptr,length);
 	init_music();
@@ -858,6 +861,12 @@ bool func_is_music_playing()
 	return adl_gv_music_playing;
 }
 
+//MAIN FUNCTION - number of times the music went back to the start since setup
+int func_get_loops()
+{
+	return adl_gv_loops;
+}
+
 void func_set_music_tempo(int value)
 {
 	adl_gv_tempo_inc = value;
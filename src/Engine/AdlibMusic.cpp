@@ -18,11 +18,15 @@
  */
 #include "AdlibMusic.h"
 #include <fstream>
+#include <sstream>
+#include <iomanip>
 #include <algorithm>
 #include "Exception.h"
 #include "Options.h"
 #include "Logger.h"
 #include "Game.h"
+#include "CrossPlatform.h"
+#include "JobSystem.h"
 #include "Adlib/fmopl.h"
 #include "Adlib/adlplayer.h"
 
@@ -34,14 +38,38 @@ namespace OpenXcom
 int AdlibMusic::delay = 0;
 int AdlibMusic::rate = 0;
 std::map<int, int> AdlibMusic::delayRates;
+SDL_mutex *AdlibMusic::_lock = 0;
+std::vector<const AdlibMusic*> AdlibMusic::_queue;
+const AdlibMusic *AdlibMusic::_rendering = 0;
+const AdlibMusic *AdlibMusic::_playing = 0;
+const AdlibMusic *AdlibMusic::_last = 0;
+bool AdlibMusic::_renderRunning = false;
+bool AdlibMusic::_stopRendering = false;
+JobGroup *AdlibMusic::_renderJobs = 0;
+size_t AdlibMusic::_position = 0;
+
+/**
+ * Renders the queued tracks one after the other, since
+ * they all go through the same Adlib player.
+ */
+class AdlibMusic::RenderJob : public Job
+{
+public:
+	void run() { AdlibMusic::renderQueue(); }
+};
 
 /**
  * Initializes a new music track.
  * @param volume Music volume modifier (1.0 = 100%).
  */
-AdlibMusic::AdlibMusic(float volume) : Music(), _data(0), _size(0), _volume(volume)
+AdlibMusic::AdlibMusic(float volume) : Music(), _data(0), _size(0), _volume(volume), _loopStart(0), _loopEnd(0), _loops(false), _rendered(false)
 {
 	rate = Options::audioSampleRate;
+	if (!_lock)
+	{
+		_lock = SDL_CreateMutex();
+		_renderJobs = new JobGroup();
+	}
 	if (!opl[0])
 	{
 		opl[0] = OPLCreate(OPL_TYPE_YM3812, 3579545, rate);
@@ -68,6 +96,15 @@ AdlibMusic::AdlibMusic(float volume) : Music(), _data(0), _size(0), _volume(volu
  */
 AdlibMusic::~AdlibMusic()
 {
+	// the renderer uses the same chips
+	stopRendering();
+	SDL_mutexP(_lock);
+	if (_playing == this)
+		_playing = 0;
+	if (_last == this)
+		_last = 0;
+	SDL_mutexV(_lock);
+
 	if (opl[0])
 	{
 		stop();
@@ -124,9 +161,380 @@ void AdlibMusic::play(int) const
 	if (!Options::mute)
 	{
 		stop();
-		func_setup_music((unsigned char*)_data, _size);
-		func_set_music_volume(127 * _volume);
-		Mix_HookMusic(player, (void*)this);
+		if (Options::cacheAdlibMusic)
+		{
+			bool start = false;
+			SDL_mutexP(_lock);
+			// only the last track played is kept in memory, the rest are in the cache
+			if (_last != 0 && _last != this && _last != _rendering && _last->_rendered &&
+				std::find(_queue.begin(), _queue.end(), _last) == _queue.end())
+			{
+				std::vector<Sint16>().swap(_last->_pcm);
+				_last->_rendered = false;
+			}
+			_last = _playing = this;
+			_position = 0;
+			if (!_rendered && _rendering != this && std::find(_queue.begin(), _queue.end(), this) == _queue.end())
+			{
+				_queue.push_back(this);
+				start = !_renderRunning;
+				_renderRunning = true;
+			}
+			SDL_mutexV(_lock);
+			// playback starts as soon as the first part is rendered
+			if (start)
+			{
+				_renderJobs->run(new RenderJob());
+			}
+			Mix_HookMusic(cachedPlayer, (void*)this);
+		}
+		else
+		{
+			stopRendering();
+			func_setup_music((unsigned char*)_data, _size);
+			func_set_music_volume(127 * _volume);
+			Mix_HookMusic(player, (void*)this);
+		}
+	}
+#endif
+}
+
+/**
+ * Plays a track rendered by the worker threads. Past the end
+ * of a track that loops it goes back to the loop start, and
+ * while the track is still being rendered it plays silence
+ * until the renderer catches up.
+ * @param udata User data to send to the player.
+ * @param stream Raw audio to output.
+ * @param len Length of audio to output.
+ */
+void AdlibMusic::cachedPlayer(void *, Uint8 *stream, int len)
+{
+#ifndef __NO_MUSIC
+	// Check SDL volume for Background Mute functionality
+	if (Options::musicVolume == 0 || Mix_VolumeMusic(-1) == 0)
+		return;
+	float volume = Game::volumeExponent(Options::musicVolume);
+	Sint16 *out = (Sint16*)stream;
+	size_t samples = len / 2;
+	SDL_mutexP(_lock);
+	const AdlibMusic *music = _playing;
+	while (music != 0 && samples > 0)
+	{
+		bool loop = music->_rendered && (music->_loops || Options::musicAlwaysLoop);
+		size_t end = loop ? music->_loopEnd : music->_pcm.size();
+		if (_position >= end)
+		{
+			if (!loop || music->_loopStart >= end)
+				break;
+			_position = music->_loopStart;
+			continue;
+		}
+		size_t n = std::min(samples, end - _position);
+		const Sint16 *in = &music->_pcm[_position];
+		for (size_t i = 0; i < n; ++i)
+		{
+			out[i] = (Sint16)(in[i] * volume);
+		}
+		out += n;
+		samples -= n;
+		_position += n;
+	}
+	SDL_mutexV(_lock);
+	std::fill(out, out + samples, 0);
+#endif
+}
+
+/**
+ * Stops the Adlib music, unless the player is busy rendering,
+ * in which case it's not playing anything anyway.
+ */
+void AdlibMusic::mute()
+{
+	if (!_lock)
+	{
+		func_mute();
+		return;
+	}
+	SDL_mutexP(_lock);
+	_playing = 0;
+	if (!_renderRunning)
+	{
+		func_mute();
+	}
+	SDL_mutexV(_lock);
+}
+
+/**
+ * Stops rendering, dropping the queued tracks,
+ * and waits for the renderer to finish.
+ */
+void AdlibMusic::stopRendering()
+{
+	if (!_lock)
+		return;
+	SDL_mutexP(_lock);
+	bool running = _renderRunning;
+	_queue.clear();
+	_stopRendering = true;
+	SDL_mutexV(_lock);
+	if (running)
+	{
+		_renderJobs->wait();
+	}
+	SDL_mutexP(_lock);
+	_stopRendering = false;
+	SDL_mutexV(_lock);
+}
+
+/**
+ * Takes tracks off the queue and renders them until it's empty.
+ */
+void AdlibMusic::renderQueue()
+{
+	for (;;)
+	{
+		SDL_mutexP(_lock);
+		if (_queue.empty() || _stopRendering)
+		{
+			_queue.clear();
+			_rendering = 0;
+			_renderRunning = false;
+			SDL_mutexV(_lock);
+			return;
+		}
+		const AdlibMusic *music = _queue.front();
+		_queue.erase(_queue.begin());
+		// skip tracks that were switched away from while queued
+		if (music != _playing)
+		{
+			SDL_mutexV(_lock);
+			continue;
+		}
+		_rendering = music;
+		SDL_mutexV(_lock);
+
+		music->render();
+
+		// only the last track played is kept in memory, the rest are in the cache
+		SDL_mutexP(_lock);
+		if (_last != music)
+		{
+			std::vector<Sint16>().swap(music->_pcm);
+			music->_rendered = false;
+		}
+		SDL_mutexV(_lock);
+	}
+}
+
+/**
+ * Works out where the rendered track is cached, from
+ * the track data, its volume and the sample rate.
+ * @return Full path of the cache file.
+ */
+std::string AdlibMusic::getCacheFile() const
+{
+	Uint64 hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < _size; ++i)
+	{
+		hash = (hash ^ (unsigned char)_data[i]) * 1099511628211ULL;
+	}
+	std::ostringstream ss;
+	ss << Options::getUserFolder() << "adlib/" << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << "-" << (int)(_volume * 100) << "-" << rate << ".pcm";
+	return ss.str();
+}
+
+/**
+ * Loads the rendered track from the cache, if it's there.
+ * @return True if it was loaded.
+ */
+bool AdlibMusic::loadCache() const
+{
+	std::ifstream file(getCacheFile().c_str(), std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	file.seekg(0, std::ifstream::end);
+	std::streamoff length = file.tellg();
+	file.seekg(0);
+	char magic[4];
+	Uint32 header[5];
+	file.read(magic, sizeof(magic));
+	file.read((char*)header, sizeof(header));
+	if (!file || std::string(magic, sizeof(magic)) != "OXAD" || header[0] != (Uint32)rate)
+	{
+		return false;
+	}
+	// don't trust the length in the header until it matches the file
+	if (length != (std::streamoff)(sizeof(magic) + sizeof(header)) + (std::streamoff)header[4] * (std::streamoff)sizeof(Sint16))
+	{
+		return false;
+	}
+	std::vector<Sint16> pcm(header[4]);
+	if (!pcm.empty())
+	{
+		file.read((char*)&pcm[0], pcm.size() * sizeof(Sint16));
+	}
+	if (!file || header[1] > header[2] || header[2] > pcm.size())
+	{
+		return false;
+	}
+
+	SDL_mutexP(_lock);
+	_pcm.swap(pcm);
+	_loopStart = header[1];
+	_loopEnd = header[2];
+	_loops = (header[3] != 0);
+	_rendered = true;
+	SDL_mutexV(_lock);
+	return true;
+}
+
+/**
+ * Saves the rendered track to the cache, so it
+ * doesn't need rendering again next time.
+ */
+void AdlibMusic::saveCache() const
+{
+	std::string folder = Options::getUserFolder() + "adlib/";
+	if (!CrossPlatform::folderExists(folder))
+	{
+		CrossPlatform::createFolder(folder);
+	}
+	std::string filename = getCacheFile();
+	std::ofstream file(filename.c_str(), std::ios::binary);
+	if (!file)
+	{
+		Log(LOG_WARNING) << "Failed to save " << filename;
+		return;
+	}
+	Uint32 header[5] = { (Uint32)rate, (Uint32)_loopStart, (Uint32)_loopEnd, _loops ? 1u : 0u, (Uint32)_pcm.size() };
+	file.write("OXAD", 4);
+	file.write((const char*)header, sizeof(header));
+	if (!_pcm.empty())
+	{
+		file.write((const char*)&_pcm[0], _pcm.size() * sizeof(Sint16));
+	}
+}
+
+/**
+ * Renders the track to 16-bit stereo PCM, tick by tick like the
+ * realtime player, into the track's buffer so it can be played
+ * while the rest is rendered. A track that starts over is rendered
+ * up to the second time, so it can loop between the two without a
+ * seam; one that ends gets a second for the notes to fade out.
+ */
+void AdlibMusic::render() const
+{
+#ifndef __NO_MUSIC
+	if (loadCache() || !opl[0] || !opl[1])
+	{
+		return;
+	}
+	std::map<int, int>::const_iterator i = delayRates.find(rate);
+	const size_t tick = ((i != delayRates.end()) ? i->second : rate / 70 * 4) / 2;
+	const size_t chunkSize = rate / 2 * 2;
+	const size_t maxSize = (size_t)rate * 2 * 60 * 10;
+	const size_t tailSize = (size_t)rate * 2;
+
+	SDL_mutexP(_lock);
+	_pcm.clear();
+	_pcm.reserve((size_t)rate * 2 * 180);
+	_rendered = false;
+	SDL_mutexV(_lock);
+
+	OPLResetChip(opl[0]);
+	OPLResetChip(opl[1]);
+	func_setup_music((unsigned char*)_data, _size);
+	func_set_music_volume(127 * _volume);
+
+	std::vector<Sint16> chunk;
+	size_t total = 0, loopStart = 0, loopEnd = 0, musicEnd = 0;
+	bool loops = false, ended = false, stopped = false;
+	for (;;)
+	{
+		func_play_tick();
+		if (func_get_loops() == 1 && loopStart == 0)
+		{
+			loopStart = total + chunk.size();
+		}
+		else if (func_get_loops() >= 2)
+		{
+			loopEnd = total + chunk.size();
+			loops = true;
+			break;
+		}
+		if (!ended && !func_is_music_playing())
+		{
+			musicEnd = total + chunk.size();
+			ended = true;
+		}
+		if ((ended && total + chunk.size() >= musicEnd + tailSize) || total + chunk.size() >= maxSize)
+		{
+			break;
+		}
+
+		size_t old = chunk.size();
+		chunk.resize(old + tick);
+		YM3812UpdateOne(opl[0], &chunk[old], tick, 2, 1.0f);
+		YM3812UpdateOne(opl[1], &chunk[old] + 1, tick, 2, 1.0f);
+
+		if (chunk.size() >= chunkSize)
+		{
+			SDL_mutexP(_lock);
+			// a track that's been switched away from isn't worth finishing
+			stopped = _stopRendering || _playing != this;
+			_pcm.insert(_pcm.end(), chunk.begin(), chunk.end());
+			SDL_mutexV(_lock);
+			total += chunk.size();
+			chunk.clear();
+			if (stopped)
+			{
+				break;
+			}
+		}
+	}
+
+	SDL_mutexP(_lock);
+	if (stopped)
+	{
+		std::vector<Sint16>().swap(_pcm);
+		// it was played again before the renderer noticed
+		if (!_stopRendering && _playing == this)
+		{
+			_queue.insert(_queue.begin(), this);
+		}
+	}
+	else
+	{
+		_pcm.insert(_pcm.end(), chunk.begin(), chunk.end());
+		total += chunk.size();
+		if (!loops)
+		{
+			// tracks that never end or start over just loop as a whole
+			if (!ended)
+			{
+				musicEnd = total;
+				loops = (loopStart > 0);
+			}
+			loopEnd = musicEnd;
+			if (!loops)
+			{
+				loopStart = 0;
+			}
+		}
+		_loopStart = loopStart;
+		_loopEnd = loopEnd;
+		_loops = loops;
+		_rendered = true;
+	}
+	SDL_mutexV(_lock);
+	func_mute();
+
+	if (!stopped)
+	{
+		saveCache();
 	}
 #endif
 }
@@ -177,6 +585,13 @@ bool AdlibMusic::isPlaying()
 #ifndef __NO_MUSIC
 	if (!Options::mute)
 	{
+		if (Options::cacheAdlibMusic)
+		{
+			SDL_mutexP(_lock);
+			bool playing = (_playing == this && (!_rendered || _loops || Options::musicAlwaysLoop || _position < _loopEnd));
+			SDL_mutexV(_lock);
+			return playing;
+		}
 		return func_is_music_playing();
 	}
 #endif
@@ -20,23 +20,54 @@
 #include "Music.h"
 #include <map>
 #include <string>
+#include <vector>
 #include <SDL_mixer.h>
+#include <SDL_thread.h>
 
 namespace OpenXcom
 {
 
+class JobGroup;
+
 /**
  * Container for Adlib music tracks.
  * Uses a custom YM3812 music player passed to SDL_mixer.
+ * With the cacheAdlibMusic option, each track is instead rendered
+ * once to PCM on the worker threads, saved to the user folder and
+ * played back from there, looping between the points where the
+ * track starts over.
  */
 class AdlibMusic : public Music
 {
 private:
+	class RenderJob;
 	char *_data;
 	size_t _size;
 	float _volume;
+	mutable std::vector<Sint16> _pcm;
+	mutable size_t _loopStart, _loopEnd;
+	mutable bool _loops, _rendered;
 	static int delay, rate;
 	static std::map<int, int> delayRates;
+	static SDL_mutex *_lock;
+	static std::vector<const AdlibMusic*> _queue;
+	static const AdlibMusic *_rendering, *_playing, *_last;
+	static bool _renderRunning, _stopRendering;
+	static JobGroup *_renderJobs;
+	static size_t _position;
+
+	/// Gets the file the rendered track is cached in.
+	std::string getCacheFile() const;
+	/// Loads the rendered track from the cache.
+	bool loadCache() const;
+	/// Saves the rendered track to the cache.
+	void saveCache() const;
+	/// Renders the track to PCM.
+	void render() const;
+	/// Renders the queued tracks.
+	static void renderQueue();
+	/// Stops rendering and waits for it.
+	static void stopRendering();
 public:
 	/// Creates a blank music track.
 	AdlibMusic(float volume = 1.0f);
@@ -50,6 +81,10 @@ public:
 	void play(int loop = -1) const;
 	/// Adlib music player.
 	static void player(void *udata, Uint8 *stream, int len);
+	/// Rendered Adlib music player.
+	static void cachedPlayer(void *udata, Uint8 *stream, int len);
+	/// Silences the Adlib music.
+	static void mute();
 	bool isPlaying();
 };
 
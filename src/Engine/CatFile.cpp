@@ -18,71 +18,119 @@
  */
 
 #include "CatFile.h"
+#include "FileMap.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <algorithm>
 #include <SDL.h>
 
 namespace OpenXcom
 {
 
 /**
- * Creates a CAT file stream. A CAT file starts with an index of the
+ * Creates a CAT file reader. A CAT file starts with an index of the
  * offset and size of every file contained within. Each file consists
- * of a filename followed by its contents.
+ * of a filename followed by its contents. Entries that run past the
+ * end of the file are cut short.
  * @param path Full path to CAT file.
  */
-CatFile::CatFile(const char *path) : std::ifstream(path, std::ios::in | std::ios::binary), _amount(0), _offset(0), _size(0)
+CatFile::CatFile(const char *path) : _file(FileMap::mapFile(path))
 {
-	// Get amount of files
-	read((char*)&_amount, sizeof(_amount));
+	if (_file == 0 || _file->getSize() < 2 * sizeof(Uint32))
+	{
+		return;
+	}
+	const Uint8 *data = _file->getData();
+	size_t fileSize = _file->getSize();
 
-	_amount = (unsigned int)SDL_SwapLE32(_amount);
-	_amount /= 2 * sizeof(_amount);
+	// Get amount of files
+	Uint32 amount;
+	memcpy(&amount, data, sizeof(amount));
+	amount = SDL_SwapLE32(amount);
+	amount /= 2 * sizeof(amount);
+	if (amount > fileSize / (2 * sizeof(amount)))
+	{
+		amount = fileSize / (2 * sizeof(amount));
+	}
 
 	// Get object offsets
-	seekg(0, std::ios::beg);
-
-	_offset = new unsigned int[_amount];
-	_size   = new unsigned int[_amount];
-
-	for (unsigned int i = 0; i < _amount; ++i)
+	_offset.resize(amount);
+	_size.resize(amount);
+	for (unsigned int i = 0; i < amount; ++i)
 	{
-		read((char*)&_offset[i], sizeof(*_offset));
-		_offset[i] = (unsigned int)SDL_SwapLE32(_offset[i]);
-		read((char*)&_size[i],   sizeof(*_size));
-		_size[i] = (unsigned int)SDL_SwapLE32(_size[i]);
+		Uint32 entry[2];
+		memcpy(entry, data + i * sizeof(entry), sizeof(entry));
+		_offset[i] = SDL_SwapLE32(entry[0]);
+		_size[i] = SDL_SwapLE32(entry[1]);
+		if (_offset[i] > fileSize)
+		{
+			_offset[i] = fileSize;
+		}
+		size_t start = _offset[i];
+		if (start < fileSize && data[start] <= 56)
+		{
+			start = std::min(fileSize, start + data[start] + 1);
+		}
+		if (_size[i] > fileSize - start)
+		{
+			_size[i] = fileSize - start;
+		}
 	}
 }
 
 /**
- * Frees associated memory.
+ * The mapping belongs to the FileMap, so there's nothing to free.
  */
 CatFile::~CatFile()
 {
-	delete[] _offset;
-	delete[] _size;
+}
+
+/**
+ * Gets an object straight from the mapped file, without the
+ * filename in front of it. It's getObjectSize() bytes long and
+ * only valid until the FileMap is cleared, so use load() to
+ * keep it for longer.
+ * @param i Object number to get.
+ * @return Pointer to the object, or 0 if there's no such object.
+ */
+const char *CatFile::getObject(unsigned int i) const
+{
+	if (i >= _offset.size())
+		return 0;
+
+	const Uint8 *object = _file->getData() + _offset[i];
+	size_t left = _file->getSize() - _offset[i];
 
-	close();
+	// Skip filename (if there's any)
+	if (left > 0 && object[0] <= 56)
+	{
+		object += std::min(left, (size_t)object[0] + 1);
+	}
+	return (const char*)object;
 }
 
 /**
- * Loads an object into memory.
+ * Loads a copy of an object into memory.
  * @param i Object number to load.
  * @param name Preserve internal file name.
  * @return Pointer to the loaded object.
  */
 char *CatFile::load(unsigned int i, bool name)
 {
-	if (i >= _amount)
+	if (i >= _offset.size())
 		return 0;
 
-	seekg(_offset[i], std::ios::beg);
+	const Uint8 *object = _file->getData() + _offset[i];
+	size_t left = _file->getSize() - _offset[i];
 
-	unsigned char namesize = peek();
+	unsigned char namesize = (left > 0) ? object[0] : 255;
 	// Skip filename (if there's any)
 	if (namesize<=56)
 	{
 		if (!name)
 		{
-			seekg(namesize + 1, std::ios::cur);
+			object += namesize + 1;
+			left -= std::min(left, (size_t)namesize + 1);
 		}
 		else
 		{
@@ -91,10 +139,12 @@ char *CatFile::load(unsigned int i, bool name)
 	}
 
 	// Read object
-	char *object = new char[_size[i]];
-	read(object, _size[i]);
+	char *copy = new char[_size[i]];
+	size_t size = std::min(left, (size_t)_size[i]);
+	memcpy(copy, object, size);
+	memset(copy + size, 0, _size[i] - size);
 
-	return object;
+	return copy;
 }
 
 }
@@ -17,38 +17,44 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <fstream>
+#include <vector>
 
 namespace OpenXcom
 {
 
+class MappedFile;
+
 /**
- * Subclass of std::ifstream to handle CAT files
+ * Reads the objects in CAT files. The file is mapped into
+ * memory through the FileMap, so objects can be read in place.
  */
-class CatFile : protected std::ifstream
+class CatFile
 {
 private:
-	unsigned int _amount, *_offset, *_size;
+	const MappedFile *_file;
+	std::vector<unsigned int> _offset, _size;
 public:
-	/// Creates a CAT file stream.
+	/// Creates a CAT file reader.
 	CatFile(const char *path);
-	/// Cleans up the stream.
+	/// Cleans up the reader.
 	~CatFile();
-	/// Inherit operator.
+	/// Checks if the file couldn't be opened.
 	bool operator !() const
 	{
-		return std::ifstream::operator!();
+		return _file == 0;
 	}
 	/// Get amount of objects.
 	int getAmount() const
 	{
-		return _amount;
+		return (int)_offset.size();
 	}
 	/// Get object size.
 	unsigned int getObjectSize(unsigned int i) const
 	{
-		return (i < _amount) ? _size[i] : 0;
+		return (i < _size.size()) ? _size[i] : 0;
 	}
+	/// Gets an object in place.
+	const char *getObject(unsigned int i) const;
 	/// Load an object into memory.
 	char *load(unsigned int i, bool name = false);
 };
@@ -20,6 +20,7 @@
 #include "FileMap.h"
 #include "Logger.h"
 #include "CrossPlatform.h"
+#include "MappedFile.h"
 #include <map>
 #include <algorithm>
 
@@ -32,6 +33,7 @@ static std::vector<std::pair<std::string, std::vector<std::string> > > _rulesets
 static std::map<std::string, std::string> _resources;
 static std::map< std::string, std::set<std::string> > _vdirs;
 static std::set<std::string> _emptySet;
+static std::map<std::string, MappedFile*> _mappedFiles;
 
 static std::string _canonicalize(const std::string &in)
 {
@@ -168,8 +170,31 @@ static void _mapFiles(const std::string &modId, const std::string &basePath,
 	}
 }
 
+const MappedFile *mapFile(const std::string &path)
+{
+	std::map<std::string, MappedFile*>::iterator i = _mappedFiles.find(path);
+	if (i != _mappedFiles.end())
+	{
+		return i->second;
+	}
+
+	MappedFile *file = new MappedFile();
+	if (!file->open(path))
+	{
+		delete file;
+		return 0;
+	}
+	_mappedFiles[path] = file;
+	return file;
+}
+
 void clear()
 {
+	for (std::map<std::string, MappedFile*>::iterator i = _mappedFiles.begin(); i != _mappedFiles.end(); ++i)
+	{
+		delete i->second;
+	}
+	_mappedFiles.clear();
 	_rulesets.clear();
 	_resources.clear();
 	_vdirs.clear();
@@ -24,6 +24,8 @@
 namespace OpenXcom
 {
 
+class MappedFile;
+
 /**
  * Maps canonical names to file paths and maintains the virtual file system
  * for resource files.
@@ -48,6 +50,12 @@ namespace FileMap
 	/// will be last in the returned vector.
 	const std::vector<std::pair<std::string, std::vector<std::string> > > &getRulesets();
 
+	/// Maps a data file into memory, given its real filesystem path (as returned by getFilePath()), so loaders
+	/// can read it in place.  Files stay mapped until clear() is called, so opening the same file again is free.
+	/// Returns 0 if the file can't be opened.  It's not thread-safe: call it from one thread at a time, like the
+	/// loader thread while mods load and the main thread once they're loaded.  Don't keep any mapping past clear().
+	const MappedFile *mapFile(const std::string &path);
+
 	/// clears FileMap state
 	void clear();
 
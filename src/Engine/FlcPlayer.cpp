@@ -36,6 +36,7 @@
 #include "Surface.h"
 #include "Options.h"
 #include "Game.h"
+#include "JobSystem.h"
 
 namespace OpenXcom
 {
@@ -79,7 +80,20 @@ enum PlayingState
 	SKIPPED
 };
 
-FlcPlayer::FlcPlayer() : _fileBuf(0), _mainScreen(0), _realScreen(0), _game(0)
+/**
+ * Decodes frames ahead of the one being shown until
+ * the ring is full, on one of the worker threads.
+ */
+class FlcPlayer::DecodeJob : public Job
+{
+private:
+	FlcPlayer *_player;
+public:
+	DecodeJob(FlcPlayer *player) : _player(player) { }
+	void run() { _player->decodeAhead(); }
+};
+
+FlcPlayer::FlcPlayer() : _fileSize(0), _chunkData(0), _frameRead(0), _framesReady(0), _decodeDone(false), _decodeStop(false), _frameLock(0), _decoding(0), _mainScreen(0), _realScreen(0), _game(0)
 {
 	_volume = Game::volumeExponent(Options::musicVolume);
 }
@@ -90,7 +104,7 @@ FlcPlayer::~FlcPlayer()
 }
 
 /**
- * Initialize data structures needed buy the player and read the whole file into memory
+ * Initialize data structures needed buy the player and open the file for streaming
  * @param filename Video file name
  * @param frameCallback Function to call each video frame
  * @param game Pointer to the Game instance
@@ -99,7 +113,7 @@ FlcPlayer::~FlcPlayer()
  */
 bool FlcPlayer::init(const char *filename, void(*frameCallBack)(), Game *game, bool useInternalAudio, int dx, int dy)
 {
-	if (_fileBuf != 0)
+	if (_videoFile.is_open())
 	{
 		Log(LOG_ERROR) << "Trying to init a video player that is already initialized";
 		return false;
@@ -115,32 +129,30 @@ bool FlcPlayer::init(const char *filename, void(*frameCallBack)(), Game *game, b
 
 	_fileSize = 0;
 	_frameCount = 0;
-	_audioFrameData = 0;
 	_hasAudio = false;
 	_audioData.loadingBuffer = 0;
 	_audioData.playingBuffer = 0;
 
-	std::ifstream file;
-	file.open(filename, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
-	if (!file.is_open())
+	// The video and the audio are read from separate places in the file
+	_videoFile.open(filename, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+	_audioFile.open(filename, std::ifstream::in | std::ifstream::binary);
+	if (!_videoFile.is_open() || !_audioFile.is_open())
 	{
 		Log(LOG_ERROR) << "Could not open FLI/FLC file: " << filename;
+		_videoFile.close();
+		_audioFile.close();
 		return false;
 	}
 
-	std::streamoff size = file.tellg();
-	file.seekg(0, std::ifstream::beg);
-
-	// TODO: substitute with a cross-platform memory mapped file?
-	_fileBuf = new Uint8[size];
+	std::streamoff size = _videoFile.tellg();
+	_videoFile.seekg(0, std::ifstream::beg);
 	_fileSize = size;
-	file.read((char *)_fileBuf, size);
-	file.close();
-
-	_audioFrameData = _fileBuf + 128;
 
 	// Let's read the first 128 bytes
-	readFileHeader();
+	Uint8 header[128] = {};
+	_videoFile.read((char *)header, std::min(size, (std::streamoff)sizeof(header)));
+	readFileHeader(header);
+	_videoPos = _audioPos = 128;
 
 	// If it's a FLC or FLI file, it's ok
 	if (_headerType == SDL_SwapLE16(FLI_TYPE) || (_headerType == SDL_SwapLE16(FLC_TYPE)))
@@ -188,10 +200,17 @@ void FlcPlayer::deInit()
 		_mainScreen = 0;
 	}
 
-	if (_fileBuf != 0)
+	if (_videoFile.is_open())
 	{
-		delete[] _fileBuf;
-		_fileBuf = 0;
+		_videoFile.close();
+		_audioFile.close();
+		std::vector<Uint8>().swap(_videoBuf);
+		std::vector<Uint8>().swap(_audioBuf);
+		std::vector<Uint8>().swap(_canvas);
+		for (int i = 0; i < FRAMES_AHEAD; ++i)
+		{
+			std::vector<Uint8>().swap(_frames[i].pixels);
+		}
 
 		deInitAudio();
 	}
@@ -210,8 +229,14 @@ void FlcPlayer::play(bool skipLastFrame)
 	_offset = _dy * _mainScreen->pitch + _mainScreen->format->BytesPerPixel * _dx;
 
 	// Skip file header
-	_videoFrameData = _fileBuf + 128;
-	_audioFrameData = _videoFrameData;
+	_videoPos = _audioPos = 128;
+
+	// The decoder draws on its own copy of the video, which starts out black like the screen
+	_canvas.assign(_screenWidth * _screenHeight, 0);
+	_frameRead = _framesReady = 0;
+	_decodeDone = _decodeStop = false;
+	_frameLock = SDL_CreateMutex();
+	_decoding = new JobGroup();
 
 	while (!shouldQuit())
 	{
@@ -227,6 +252,14 @@ void FlcPlayer::play(bool skipLastFrame)
 			SDLPolling();
 	}
 
+	// Let the decoder know it can stop and wait for it
+	SDL_mutexP(_frameLock);
+	_decodeStop = true;
+	SDL_mutexV(_frameLock);
+	delete _decoding;
+	_decoding = 0;
+	SDL_DestroyMutex(_frameLock);
+	_frameLock = 0;
 }
 
 void FlcPlayer::delay(Uint32 milliseconds)
@@ -277,15 +310,15 @@ bool FlcPlayer::shouldQuit()
 	return _playingState == FINISHED || _playingState == SKIPPED;
 }
 
-void FlcPlayer::readFileHeader()
+void FlcPlayer::readFileHeader(const Uint8 *header)
 {
-	readU32(_headerSize, _fileBuf);
-	readU16(_headerType, _fileBuf + 4);
-	readU16(_headerFrames, _fileBuf + 6);
-	readU16(_headerWidth, _fileBuf + 8);
-	readU16(_headerHeight, _fileBuf + 10);
-	readU16(_headerDepth, _fileBuf + 12);
-	readU16(_headerSpeed, _fileBuf + 16);
+	readU32(_headerSize, header);
+	readU16(_headerType, header + 4);
+	readU16(_headerFrames, header + 6);
+	readU16(_headerWidth, header + 8);
+	readU16(_headerHeight, header + 10);
+	readU16(_headerDepth, header + 12);
+	readU16(_headerSpeed, header + 16);
 }
 
 bool FlcPlayer::isValidFrame(Uint8 *frameHeader, Uint32 &frameSize, Uint16 &frameType)
@@ -296,150 +329,279 @@ bool FlcPlayer::isValidFrame(Uint8 *frameHeader, Uint32 &frameSize, Uint16 &fram
 	return (frameType == FRAME_TYPE || frameType == AUDIO_CHUNK || frameType == PREFIX_CHUNK);
 }
 
+/**
+ * Reads the next frame of the file from a stream. Only frames of
+ * the wanted type are read into memory, the rest are just skipped.
+ * @param file Stream to read from.
+ * @param pos Position of the frame in the file, moved past it.
+ * @param data Buffer to read the frame into.
+ * @param frameSize Size of the frame, from its header.
+ * @param frameType Type of the frame, from its header.
+ * @param wantedType Type of frame to read.
+ * @return False if there's no valid frame there.
+ */
+bool FlcPlayer::readFrame(std::ifstream &file, Uint32 &pos, std::vector<Uint8> &data, Uint32 &frameSize, Uint16 &frameType, Uint16 wantedType)
+{
+	Uint8 header[6] = {};
+	if (_fileSize - pos < sizeof(header))
+	{
+		return false;
+	}
+	file.clear();
+	file.seekg(pos, std::ifstream::beg);
+	file.read((char *)header, sizeof(header));
+	if (!isValidFrame(header, frameSize, frameType))
+	{
+		return false;
+	}
+
+	// Audio chunks don't count their own header
+	Uint32 length = (frameType == AUDIO_CHUNK) ? frameSize + 16 : frameSize;
+	length = std::min(length, _fileSize - pos);
+	if (length < sizeof(header))
+	{
+		return false;
+	}
+	if (frameType == wantedType)
+	{
+		// Always room for the frame header, even if the file is cut short
+		data.assign(std::max(length, (Uint32)16), 0);
+		std::copy(header, header + sizeof(header), data.begin());
+		file.read((char *)&data[sizeof(header)], length - sizeof(header));
+	}
+	pos += length;
+	return true;
+}
+
 void FlcPlayer::decodeAudio(int frames)
 {
 
 	int audioFramesFound = 0;
 
-	while (audioFramesFound < frames && !isEndOfFile(_audioFrameData))
+	while (audioFramesFound < frames && !isEndOfFile(_audioPos))
 	{
-		if (!isValidFrame(_audioFrameData, _audioFrameSize, _audioFrameType))
+		if (!readFrame(_audioFile, _audioPos, _audioBuf, _audioFrameSize, _audioFrameType, AUDIO_CHUNK))
 		{
 			_playingState = FINISHED;
 			break;
 		}
 
-		switch (_audioFrameType)
+		if (_audioFrameType == AUDIO_CHUNK)
 		{
-			case FRAME_TYPE:
-			case PREFIX_CHUNK:
-				_audioFrameData += _audioFrameSize;
-				break;
-			case AUDIO_CHUNK:
-				Uint16 sampleRate;
-
-				readU16(sampleRate, _audioFrameData + 8);
-
-				_chunkData = _audioFrameData + 16;
+			Uint16 sampleRate;
 
-				playAudioFrame(sampleRate);
+			readU16(sampleRate, &_audioBuf[8]);
 
-				_audioFrameData += _audioFrameSize + 16;
+			playAudioFrame(sampleRate, &_audioBuf[16]);
 
-				++audioFramesFound;
-
-				break;
+			++audioFramesFound;
 		}
 	}
 }
 
+/**
+ * Shows the next decoded frame once it's due.
+ * @param skipLastFrame Don't show the last frame of the video.
+ */
 void FlcPlayer::decodeVideo(bool skipLastFrame)
 {
-	bool videoFrameFound = false;
+	Frame *frame = getNextFrame();
+	if (frame == 0 || frame->end)
+	{
+		_playingState = FINISHED;
+		return;
+	}
 
-	while (!videoFrameFound)
+	Uint32 delay;
+	if (_headerType == FLI_TYPE)
+	{
+		delay = frame->delayOverride > 0 ? frame->delayOverride : _headerSpeed * (1000.0 / 70.0);
+	}
+	else if (_useInternalAudio && !_frameCallBack) // this means TFTD videos are playing
+	{
+		delay = _videoDelay;
+	}
+	else
 	{
-		if (!isValidFrame(_videoFrameData, _videoFrameSize, _videoFrameType))
+		delay = _headerSpeed;
+	}
+
+	waitForNextFrame(delay);
+
+	// If this frame is the last one, don't play it
+	if (frame->last)
+		_playingState = FINISHED;
+
+	if (!shouldQuit() || !skipLastFrame)
+		playVideoFrame(*frame);
+
+	// Hand the frame back to the decoder
+	SDL_mutexP(_frameLock);
+	_frameRead = (_frameRead + 1) % FRAMES_AHEAD;
+	_framesReady--;
+	SDL_mutexV(_frameLock);
+}
+
+/**
+ * Gets the next decoded frame, getting the decoder going
+ * if it's idle and waiting for it if it's behind.
+ * @return Pointer to the frame, or 0 if there's none left.
+ */
+FlcPlayer::Frame *FlcPlayer::getNextFrame()
+{
+	for (;;)
+	{
+		SDL_mutexP(_frameLock);
+		int ready = _framesReady;
+		bool done = _decodeDone;
+		SDL_mutexV(_frameLock);
+		if (ready > 0)
 		{
-			_playingState = FINISHED;
-			break;
+			if (!done && _decoding->isDone())
+			{
+				_decoding->run(new DecodeJob(this));
+			}
+			return &_frames[_frameRead];
+		}
+		if (done)
+		{
+			return 0;
+		}
+		if (_decoding->isDone())
+		{
+			_decoding->run(new DecodeJob(this));
 		}
+		_decoding->wait();
+	}
+}
 
-		switch (_videoFrameType)
+/**
+ * Decodes frames until the ring is full or the video ends.
+ * Only ever runs once at a time, since frames build on the last.
+ */
+void FlcPlayer::decodeAhead()
+{
+	for (;;)
+	{
+		SDL_mutexP(_frameLock);
+		bool full = (_framesReady == FRAMES_AHEAD || _decodeDone || _decodeStop);
+		int slot = (_frameRead + _framesReady) % FRAMES_AHEAD;
+		SDL_mutexV(_frameLock);
+		if (full)
 		{
-		case FRAME_TYPE:
+			return;
+		}
 
-			Uint32 delay;
+		Frame &frame = _frames[slot];
+		decodeFrame(frame);
 
-			readU16(_frameChunks, _videoFrameData + 6);
-			readU16(_delayOverride, _videoFrameData + 8);
+		SDL_mutexP(_frameLock);
+		_framesReady++;
+		_decodeDone = (frame.last || frame.end);
+		SDL_mutexV(_frameLock);
+	}
+}
 
-			if (_headerType == FLI_TYPE)
-			{
-				delay = _delayOverride > 0 ? _delayOverride : _headerSpeed * (1000.0 / 70.0);
-			}
-			else if (_useInternalAudio && !_frameCallBack) // this means TFTD videos are playing
-			{
-				delay = _videoDelay;
-			}
-			else
-			{
-				delay = _headerSpeed;
-			}
+/**
+ * Reads the next video frame of the file, skipping the audio,
+ * and decodes it onto the canvas.
+ * @param frame Frame to store the result in.
+ */
+void FlcPlayer::decodeFrame(Frame &frame)
+{
+	frame.palettes.clear();
+	frame.delayOverride = 0;
+	frame.last = false;
+	frame.end = false;
 
-			waitForNextFrame(delay);
+	for (;;)
+	{
+		if (!readFrame(_videoFile, _videoPos, _videoBuf, _videoFrameSize, _videoFrameType, FRAME_TYPE))
+		{
+			frame.end = true;
+			return;
+		}
 
-			// Skip the frame header, we are not interested in the rest
-			_chunkData = _videoFrameData + 16;
+		if (_videoFrameType == FRAME_TYPE)
+		{
+			readU16(_frameChunks, &_videoBuf[6]);
+			readU16(frame.delayOverride, &_videoBuf[8]);
 
-			_videoFrameData += _videoFrameSize;
-			// If this frame is the last one, don't play it
-			if(isEndOfFile(_videoFrameData))
-				_playingState = FINISHED;
+			// Skip the frame header, we are not interested in the rest
+			_chunkData = &_videoBuf[16];
 
-			if(!shouldQuit() || !skipLastFrame)
-				playVideoFrame();
+			int chunkCount = _frameChunks;
+			for (int i = 0; i < chunkCount; ++i)
+			{
+				readU32(_chunkSize, _chunkData);
+				readU16(_chunkType, _chunkData + 4);
 
-			videoFrameFound = true;
+				switch (_chunkType)
+				{
+					case COLOR_256:
+						color256(frame);
+						break;
+					case FLI_SS2:
+						fliSS2();
+						break;
+					case COLOR_64:
+						color64(frame);
+						break;
+					case FLI_LC:
+						fliLC();
+						break;
+					case BLACK:
+						black();
+						break;
+					case FLI_BRUN:
+						fliBRun();
+						break;
+					case FLI_COPY:
+						fliCopy();
+						break;
+					case 18:
+						break;
+					default:
+						Log(LOG_WARNING) << "Ieek an non implemented chunk type:" << _chunkType;
+						break;
+				}
 
-			break;
-		case AUDIO_CHUNK:
-			_videoFrameData += _videoFrameSize + 16;
-			break;
-		case PREFIX_CHUNK:
-			// Just skip it
-			_videoFrameData += _videoFrameSize;
+				_chunkData += _chunkSize;
+			}
 
-			break;
+			frame.pixels = _canvas;
+			frame.last = isEndOfFile(_videoPos);
+			return;
 		}
 	}
 }
 
-void FlcPlayer::playVideoFrame()
+/**
+ * Puts a decoded frame on the screen.
+ * @param frame Frame to show.
+ */
+void FlcPlayer::playVideoFrame(Frame &frame)
 {
 	++_frameCount;
+	for (std::vector<PaletteUpdate>::iterator i = frame.palettes.begin(); i != frame.palettes.end(); ++i)
+	{
+		if (_mainScreen != _realScreen->getSurface()->getSurface())
+			SDL_SetColors(_mainScreen, i->colors, i->first, i->count);
+		_realScreen->setPalette(i->colors, i->first, i->count, true);
+	}
+
 	if (SDL_LockSurface(_mainScreen) < 0)
 		return;
-	int chunkCount = _frameChunks;
-
-	for (int i = 0; i < chunkCount; ++i)
+	int width = std::max(0, std::min(_screenWidth, _mainScreen->w - _dx));
+	int height = std::min(_screenHeight, _mainScreen->h - _dy);
+	Uint8 *pSrc = &frame.pixels[0];
+	Uint8 *pDst = (Uint8*)_mainScreen->pixels + _offset;
+	for (int y = 0; y < height; ++y)
 	{
-		readU32(_chunkSize, _chunkData);
-		readU16(_chunkType, _chunkData + 4);
-
-		switch (_chunkType)
-		{
-			case COLOR_256:
-				color256();
-				break;
-			case FLI_SS2:
-				fliSS2();
-				break;
-			case COLOR_64:
-				color64();
-				break;
-			case FLI_LC:
-				fliLC();
-				break;
-			case BLACK:
-				black();
-				break;
-			case FLI_BRUN:
-				fliBRun();
-				break;
-			case FLI_COPY:
-				fliCopy();
-				break;
-			case 18:
-				break;
-			default:
-				Log(LOG_WARNING) << "Ieek an non implemented chunk type:" << _chunkType;
-				break;
-		}
-
-		_chunkData += _chunkSize;
+		memcpy(pDst, pSrc, width);
+		pSrc += _screenWidth;
+		pDst += _mainScreen->pitch;
 	}
-
 	SDL_UnlockSurface(_mainScreen);
 
 	/* TODO: Track which rectangles have really changed */
@@ -450,7 +612,7 @@ void FlcPlayer::playVideoFrame()
 	_realScreen->flip();
 }
 
-void FlcPlayer::playAudioFrame(Uint16 sampleRate)
+void FlcPlayer::playAudioFrame(Uint16 sampleRate, const Uint8 *samples)
 {
 	/* TFTD audio header (10 bytes)
 	* Uint16 unknown1 - always 0
@@ -488,7 +650,7 @@ void FlcPlayer::playAudioFrame(Uint16 sampleRate)
 
 		for (unsigned int i = 0; i < _audioFrameSize; i++)
 		{
-			loadingBuff->samples[loadingBuff->sampleCount + i] = (float)((_chunkData[i]) -128) * 240 * _volume;
+			loadingBuff->samples[loadingBuff->sampleCount + i] = (float)((samples[i]) -128) * 240 * _volume;
 		}
 		loadingBuff->sampleCount += _audioFrameSize;
 
@@ -500,7 +662,7 @@ void FlcPlayer::playAudioFrame(Uint16 sampleRate)
 	}
 }
 
-void FlcPlayer::color256()
+void FlcPlayer::color256(Frame &frame)
 {
 	Uint8 *pSrc;
 	Uint16 numColorPackets;
@@ -527,9 +689,11 @@ void FlcPlayer::color256()
 			_colors[i].b = *(pSrc++);
 		}
 
-		if (_mainScreen != _realScreen->getSurface()->getSurface())
-			SDL_SetColors(_mainScreen, _colors, numColorsSkip, numColors);
-		_realScreen->setPalette(_colors, numColorsSkip, numColors, true);
+		PaletteUpdate update;
+		std::copy(_colors, _colors + numColors, update.colors);
+		update.first = numColorsSkip;
+		update.count = numColors;
+		frame.palettes.push_back(update);
 
 		if (numColorPackets >= 1)
 		{
@@ -549,7 +713,7 @@ void FlcPlayer::fliSS2()
 	Uint8 lastByte = 0;
 
 	pSrc = _chunkData + 6;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = &_canvas[0];
 	readU16(lines, pSrc);
 
 	pSrc += 2;
@@ -561,7 +725,7 @@ void FlcPlayer::fliSS2()
 
 		if ((count & MASK) == SKIP_LINES)
 		{
-			pDst += (-count)*_mainScreen->pitch;
+			pDst += (-count)*_screenWidth;
 			++lines;
 			continue;
 		}
@@ -610,9 +774,9 @@ void FlcPlayer::fliSS2()
 			if (setLastByte)
 			{
 				setLastByte = false;
-				*(pDst + _mainScreen->pitch - 1) = lastByte;
+				*(pDst + _screenWidth - 1) = lastByte;
 			}
-			pDst += _mainScreen->pitch;
+			pDst += _screenWidth;
 		}
 	}
 }
@@ -625,7 +789,7 @@ void FlcPlayer::fliBRun()
 
 	heightCount = _headerHeight;
 	pSrc = _chunkData + 6; // Skip chunk header
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = &_canvas[0];
 
 	while (heightCount--)
 	{
@@ -657,7 +821,7 @@ void FlcPlayer::fliBRun()
 				}
 			}
 		}
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -672,11 +836,11 @@ void FlcPlayer::fliLC()
 	int packetsCount;
 
 	pSrc = _chunkData + 6;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = &_canvas[0];
 
 	readU16(tmp, pSrc);
 	pSrc += 2;
-	pDst += tmp*_mainScreen->pitch;
+	pDst += tmp*_screenWidth;
 	readU16(lines, pSrc);
 	pSrc += 2;
 
@@ -711,11 +875,11 @@ void FlcPlayer::fliLC()
 				}
 			}
 		}
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
-void FlcPlayer::color64()
+void FlcPlayer::color64(Frame &frame)
 {
 	Uint8 *pSrc;
 	Uint16 NumColors, NumColorPackets;
@@ -742,9 +906,11 @@ void FlcPlayer::color64()
 			_colors[i].b = *(pSrc++) << 2;
 		}
 
-		if (_mainScreen != _realScreen->getSurface()->getSurface())
-			SDL_SetColors(_mainScreen, _colors, NumColorsSkip, NumColors);
-		_realScreen->setPalette(_colors, NumColorsSkip, NumColors, true);
+		PaletteUpdate update;
+		std::copy(_colors, _colors + NumColors, update.colors);
+		update.first = NumColorsSkip;
+		update.count = NumColors;
+		frame.palettes.push_back(update);
 	}
 }
 
@@ -753,13 +919,13 @@ void FlcPlayer::fliCopy()
 	Uint8 *pSrc, *pDst;
 	int Lines = _screenHeight;
 	pSrc = _chunkData + 6;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = &_canvas[0];
 
 	while (Lines--)
 	{
 		memcpy(pDst, pSrc, _screenWidth);
 		pSrc += _screenWidth;
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -767,12 +933,12 @@ void FlcPlayer::black()
 {
 	Uint8 *pDst;
 	int Lines = _screenHeight;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = &_canvas[0];
 
 	while (Lines-- > 0)
 	{
 		memset(pDst, 0, _screenHeight);
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -884,9 +1050,9 @@ void FlcPlayer::stop()
 	_playingState = FINISHED;
 }
 
-bool FlcPlayer::isEndOfFile(Uint8 *pos)
+bool FlcPlayer::isEndOfFile(Uint32 pos)
 {
-	return (pos - _fileBuf) == (int)(_fileSize); // should be Sint64, but let's assume the videos won't be 2gb
+	return pos >= _fileSize;
 }
 
 int FlcPlayer::getFrameCount()
@@ -923,7 +1089,7 @@ void FlcPlayer::waitForNextFrame(Uint32 delay)
 	{
 		while (currentTick < newTick)
 		{
-			while ((newTick - currentTick) > 10 && !isEndOfFile(_audioFrameData))
+			while ((newTick - currentTick) > 10 && !isEndOfFile(_audioPos))
 			{
 				decodeAudio(1);
 				currentTick = SDL_GetTicks();
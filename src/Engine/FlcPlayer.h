@@ -22,23 +22,58 @@
 /*
  * Based on http://www.libsdl.org/projects/flxplay/
  */
+#include <fstream>
+#include <vector>
 #include <SDL.h>
+#include <SDL_thread.h>
 
 namespace OpenXcom
 {
 
 class Screen;
 class Game;
+class JobGroup;
 
+/**
+ * Plays FLI/FLC videos. The file is streamed rather than loaded whole:
+ * a job on the worker threads reads and decodes the video a few frames
+ * ahead into a ring of frames, while the main thread reads the audio
+ * from its own place in the file and presents the decoded frames.
+ */
 class FlcPlayer
 {
 private:
+	/// Number of frames decoded ahead of the one shown.
+	static const int FRAMES_AHEAD = 4;
+
+	/// Colors changed by a frame, applied when it's shown.
+	struct PaletteUpdate
+	{
+		SDL_Color colors[256];
+		int first, count;
+	};
+
+	/// A decoded frame waiting to be shown.
+	struct Frame
+	{
+		std::vector<Uint8> pixels;
+		std::vector<PaletteUpdate> palettes;
+		Uint16 delayOverride;
+		bool last, end;
+	};
+
+	class DecodeJob;
 
-	Uint8 *_fileBuf;
+	std::ifstream _videoFile, _audioFile;
 	Uint32 _fileSize;
-	Uint8 *_videoFrameData;
+	Uint32 _videoPos, _audioPos;
+	std::vector<Uint8> _videoBuf, _audioBuf, _canvas;
 	Uint8 *_chunkData;
-	Uint8 *_audioFrameData;
+	Frame _frames[FRAMES_AHEAD];
+	int _frameRead, _framesReady;
+	bool _decodeDone, _decodeStop;
+	SDL_mutex *_frameLock;
+	JobGroup *_decoding;
 	Uint16 _frameCount;    /* Frame Counter */
 	Uint32 _headerSize;    /* Fli file size */
 	Uint16 _headerType;    /* Fli header check */
@@ -52,7 +87,6 @@ private:
 	Uint16 _frameChunks;   /* Number of chunks in frame */
 	Uint32 _chunkSize;     /* Size of chunk */
 	Uint16 _chunkType;     /* Type of chunk */
-	Uint16 _delayOverride; /* FRAME_TYPE extension */
 	Uint32 _audioFrameSize;
 	Uint16 _audioFrameType;
 
@@ -97,29 +131,33 @@ private:
 	void readU32(Uint32 &dst, const Uint8 *const src);
 	void readS16(Sint16 &dst, const Sint8 *const src);
 	void readS32(Sint32 &dst, const Sint8 *const src);
-	void readFileHeader();
+	void readFileHeader(const Uint8 *header);
 
 	bool isValidFrame(Uint8 *frameHeader, Uint32 &frameSize, Uint16 &frameType);
+	bool readFrame(std::ifstream &file, Uint32 &pos, std::vector<Uint8> &data, Uint32 &frameSize, Uint16 &frameType, Uint16 wantedType);
 	void decodeVideo(bool skipLastFrame);
+	void decodeAhead();
+	void decodeFrame(Frame &frame);
+	Frame *getNextFrame();
 	void decodeAudio(int frames);
 	void waitForNextFrame(Uint32 delay);
 	void SDLPolling();
 	bool shouldQuit();
 
-	void playVideoFrame();
-	void color256();
+	void playVideoFrame(Frame &frame);
+	void color256(Frame &frame);
 	void fliBRun();
 	void fliCopy();
 	void fliSS2();
 	void fliLC();
-	void color64();
+	void color64(Frame &frame);
 	void black();
 
-	void playAudioFrame(Uint16 sampleRate);
+	void playAudioFrame(Uint16 sampleRate, const Uint8 *samples);
 	void initAudio(Uint16 format, Uint8 channels);
 	void deInitAudio();
 
-	bool isEndOfFile(Uint8 *pos);
+	bool isEndOfFile(Uint32 pos);
 
 	static void audioCallback(void *userData, Uint8 *stream, int len);
 
@@ -17,19 +17,42 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Font.h"
+#include <algorithm>
 #include "DosFont.h"
 #include "Surface.h"
 #include "FileMap.h"
 #include "Unicode.h"
+#include "ShaderDraw.h"
+#include "ShaderMove.h"
 
 namespace OpenXcom
 {
 
+namespace
+{
+
+struct GlyphCopy
+{
+	static inline void func(Uint8& dest, const Uint8& src, const int&, const int&, const int&)
+	{
+		if (src)
+		{
+			dest = src;
+		}
+	}
+};
+
+} //namespace
+
 /**
  * Initializes the font with a blank surface.
  */
-Font::Font() : _monospace(false)
+Font::Font() : _pages(0x10000 / PAGE_SIZE), _monospace(false)
 {
+	_blank.surface = 0;
+	_blank.rect.x = _blank.rect.y = 0;
+	_blank.rect.w = _blank.rect.h = 0;
+	_blank.spacing = 0;
 }
 
 /**
@@ -37,6 +60,7 @@ Font::Font() : _monospace(false)
  */
 Font::~Font()
 {
+	clearRuns();
 	for (std::vector<FontImage>::iterator i = _images.begin(); i != _images.end(); ++i)
 	{
 		delete (*i).surface;
@@ -118,7 +142,8 @@ void Font::init(size_t index, const UString &str)
 			rect.y = startY;
 			rect.w = image->width;
 			rect.h = image->height;
-			_chars[str[i]] = std::make_pair(index, rect);
+			FontGlyph glyph = { surface, rect, image->spacing };
+			addGlyph(str[i], glyph);
 		}
 	}
 	else
@@ -156,10 +181,63 @@ void Font::init(size_t index, const UString &str)
 			rect.w = right - left + 1;
 			rect.h = image->height;
 
-			_chars[str[i]] = std::make_pair(index, rect);
+			FontGlyph glyph = { surface, rect, image->spacing };
+			addGlyph(str[i], glyph);
 		}
 	}
 	surface->unlock();
+	if (_blank.surface == 0)
+	{
+		_blank.surface = surface;
+	}
+}
+
+/**
+ * Stores a character of the font, in the page table if
+ * it's in the Basic Multilingual Plane.
+ * @param c Character code.
+ * @param glyph Image and size of the character.
+ */
+void Font::addGlyph(UCode c, const FontGlyph &glyph)
+{
+	if (c < _pages.size() * PAGE_SIZE)
+	{
+		std::vector<FontGlyph> &page = _pages[c / PAGE_SIZE];
+		if (page.empty())
+		{
+			FontGlyph missing = { 0, _blank.rect, 0 };
+			page.resize(PAGE_SIZE, missing);
+		}
+		page[c % PAGE_SIZE] = glyph;
+	}
+	else
+	{
+		_chars[c] = glyph;
+	}
+}
+
+/**
+ * Looks up a character in the font.
+ * @param c Character code.
+ * @return Pointer to the character, or 0 if it's not in the font.
+ */
+const FontGlyph *Font::findGlyph(UCode c) const
+{
+	if (c < _pages.size() * PAGE_SIZE)
+	{
+		const std::vector<FontGlyph> &page = _pages[c / PAGE_SIZE];
+		if (!page.empty() && page[c % PAGE_SIZE].surface != 0)
+		{
+			return &page[c % PAGE_SIZE];
+		}
+		return 0;
+	}
+	std::map<UCode, FontGlyph>::const_iterator i = _chars.find(c);
+	if (i != _chars.end())
+	{
+		return &i->second;
+	}
+	return 0;
 }
 
 /**
@@ -170,13 +248,95 @@ void Font::init(size_t index, const UString &str)
  */
 Surface *Font::getChar(UCode c)
 {
-	if (_chars.find(c) == _chars.end())
-		c = '?';
-	Surface *surface = _images[_chars[c].first].surface;
-	*surface->getCrop() = _chars[c].second;
+	const FontGlyph *glyph = getGlyph(c);
+	*glyph->surface->getCrop() = glyph->rect;
+	return glyph->surface;
+}
+
+/**
+ * Returns the image and size of a particular character,
+ * or of '?' if it's not in the font.
+ * @param c Font character.
+ * @return Pointer to the character.
+ */
+const FontGlyph *Font::getGlyph(UCode c) const
+{
+	const FontGlyph *glyph = findGlyph(c);
+	if (glyph == 0)
+	{
+		glyph = findGlyph('?');
+		if (glyph == 0)
+		{
+			glyph = &_blank;
+		}
+	}
+	return glyph;
+}
+
+/**
+ * Returns a run of characters on one line drawn with the font,
+ * left to right, drawing it the first time it's needed.
+ * The run keeps the font's color indexes so it can be
+ * shifted to any text color when blitted.
+ * @param run Characters in the run, without linebreaks.
+ * @return Pointer to the surface with the run,
+ * or 0 if there's nothing to draw.
+ */
+Surface *Font::getRun(const UString &run)
+{
+	std::map<UString, Surface*>::iterator i = _runs.find(run);
+	if (i != _runs.end())
+	{
+		return i->second;
+	}
+
+	int width = 0, height = 0, x = 0;
+	for (UString::const_iterator c = run.begin(); c != run.end(); ++c)
+	{
+		if (!Unicode::isSpace(*c) && *c != '\t')
+		{
+			const FontGlyph *glyph = getGlyph(*c);
+			width = std::max(width, x + glyph->rect.w);
+			height = std::max(height, (int)glyph->rect.h);
+		}
+		x += getCharSize(*c).w;
+	}
+	if (width <= 0 || height <= 0)
+	{
+		return 0;
+	}
+	if (_runs.size() >= MAX_RUNS)
+	{
+		clearRuns();
+	}
+
+	Surface *surface = new Surface(width, height);
+	x = 0;
+	for (UString::const_iterator c = run.begin(); c != run.end(); ++c)
+	{
+		if (!Unicode::isSpace(*c) && *c != '\t')
+		{
+			Surface *chr = getChar(*c);
+			ShaderDraw<GlyphCopy>(ShaderSurface(surface, 0, 0), ShaderCrop(chr, x, 0));
+		}
+		x += getCharSize(*c).w;
+	}
+	_runs[run] = surface;
 	return surface;
 }
 
+/**
+ * Deletes all the runs drawn with the font.
+ */
+void Font::clearRuns()
+{
+	for (std::map<UString, Surface*>::iterator i = _runs.begin(); i != _runs.end(); ++i)
+	{
+		delete i->second;
+	}
+	_runs.clear();
+}
+
 /**
  * Returns the maximum width for any character in the font.
  * @return Width in pixels.
@@ -216,12 +376,9 @@ SDL_Rect Font::getCharSize(UCode c)
 	SDL_Rect size = { 0, 0, 0, 0 };
 	if (Unicode::isPrintable(c))
 	{
-		if (_chars.find(c) == _chars.end())
-			c = '?';
-
-		FontImage *image = &_images[_chars[c].first];
-		size.w = _chars[c].second.w + image->spacing;
-		size.h = _chars[c].second.h + image->spacing;
+		const FontGlyph *glyph = getGlyph(c);
+		size.w = glyph->rect.w + glyph->spacing;
+		size.h = glyph->rect.h + glyph->spacing;
 	}
 	else
 	{
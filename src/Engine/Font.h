@@ -37,20 +37,39 @@ struct FontImage
 	Surface *surface;
 };
 
+struct FontGlyph
+{
+	Surface *surface;
+	SDL_Rect rect;
+	int spacing;
+};
+
 /**
  * Takes care of loading and storing each character in a sprite font.
  * Sprite fonts consist of a set of characters split in fixed-size regions.
  * @note The characters don't all need to be the same size, they can
  * have blank space and will be automatically lined up properly.
+ * Characters in the Basic Multilingual Plane are looked up in a table,
+ * and runs of text drawn with the font are kept so they can be blitted
+ * in one go next time.
  */
 class Font
 {
 private:
+	static const UCode PAGE_SIZE = 256;
+	static const size_t MAX_RUNS = 1024;
 	std::vector<FontImage> _images;
-	std::map< UCode, std::pair<size_t, SDL_Rect> > _chars;
+	std::vector< std::vector<FontGlyph> > _pages;
+	std::map<UCode, FontGlyph> _chars;
+	FontGlyph _blank;
+	std::map<UString, Surface*> _runs;
 	bool _monospace;
 	/// Determines the size and position of each character in the font.
 	void init(size_t index, const UString &str);
+	/// Stores a character of the font.
+	void addGlyph(UCode c, const FontGlyph &glyph);
+	/// Looks up a character of the font.
+	const FontGlyph *findGlyph(UCode c) const;
 public:
 
 	/// Creates a blank font.
@@ -63,6 +82,12 @@ public:
 	void loadTerminal();
 	/// Gets a particular character from the font, with its real size.
 	Surface *getChar(UCode c);
+	/// Gets the image and size of a particular character.
+	const FontGlyph *getGlyph(UCode c) const;
+	/// Gets a run of characters drawn with the font.
+	Surface *getRun(const UString &run);
+	/// Removes all the stored runs.
+	void clearRuns();
 	/// Gets the font's character width.
 	int getWidth() const;
 	/// Gets the font's character height.
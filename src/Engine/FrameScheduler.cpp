@@ -0,0 +1,168 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "FrameScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <SDL.h>
+#include "Profiler.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a scheduler that presents frames as fast as it can.
+ */
+FrameScheduler::FrameScheduler() : _interval(0.0), _nextFrame(0.0), _lastFrame(0.0), _oversleep(0.001), _frame(0), _count(0)
+{
+	std::fill(_frames, _frames + FRAMES, 0.0f);
+}
+
+/**
+ *
+ */
+FrameScheduler::~FrameScheduler()
+{
+}
+
+/**
+ * Changes how many frames are presented each second.
+ * @param fps Frames per second, or 0 for no limit.
+ */
+void FrameScheduler::setRate(int fps)
+{
+	double interval = (fps > 0) ? 1.0 / fps : 0.0;
+	if (interval != _interval)
+	{
+		_interval = interval;
+		_nextFrame = _lastFrame + _interval;
+	}
+}
+
+/**
+ * Checks if the next frame is due.
+ * @param now Current time, in seconds.
+ * @return True if a frame should be presented.
+ */
+bool FrameScheduler::isFrameDue(double now) const
+{
+	return now >= _nextFrame;
+}
+
+/**
+ * Records the time since the last frame and schedules the next one.
+ * Frames are kept on a fixed cadence, so one that's a bit late doesn't
+ * push back the rest, unless the game fell more than a frame behind.
+ * @param now Current time, in seconds.
+ */
+void FrameScheduler::frameDone(double now)
+{
+	if (_lastFrame > 0.0)
+	{
+		_frames[_frame] = (float)((now - _lastFrame) * 1000.0);
+		_frame = (_frame + 1) % FRAMES;
+		_count = std::min(_count + 1, FRAMES);
+	}
+	_lastFrame = now;
+	_nextFrame += _interval;
+	if (_nextFrame <= now)
+	{
+		_nextFrame = now + _interval;
+	}
+}
+
+/**
+ * Returns the time the next frame is due.
+ * @return Time in seconds.
+ */
+double FrameScheduler::getNextFrame() const
+{
+	return _nextFrame;
+}
+
+/**
+ * Sleeps until the given time. SDL_Delay often sleeps a bit
+ * longer than asked, so it's asked for a bit less, going by how
+ * late it was before, and the rest is made up by yielding.
+ * @param time Time to wake up, in seconds.
+ */
+void FrameScheduler::sleepUntil(double time)
+{
+	double start = Profiler::getTime();
+	double wait = time - start - _oversleep;
+	if (wait >= 0.001)
+	{
+		Uint32 ms = (Uint32)(wait * 1000.0);
+		SDL_Delay(ms);
+		double late = Profiler::getTime() - start - ms / 1000.0;
+		_oversleep = std::min(0.01, _oversleep * 0.9 + std::max(0.0, late) * 0.1);
+	}
+	while (Profiler::getTime() < time)
+	{
+		SDL_Delay(0);
+	}
+}
+
+/**
+ * Returns the average time between the last frames.
+ * @return Time in milliseconds.
+ */
+float FrameScheduler::getAverageFrameTime() const
+{
+	if (_count == 0)
+	{
+		return 0.0f;
+	}
+	float total = 0.0f;
+	for (int i = 0; i < _count; ++i)
+	{
+		total += _frames[i];
+	}
+	return total / _count;
+}
+
+/**
+ * Returns the longest time between the last frames.
+ * @return Time in milliseconds.
+ */
+float FrameScheduler::getWorstFrameTime() const
+{
+	return *std::max_element(_frames, _frames + FRAMES);
+}
+
+/**
+ * Returns the standard deviation of the time between the
+ * last frames, which is low when the animation is steady.
+ * @return Time in milliseconds.
+ */
+float FrameScheduler::getFrameTimeDeviation() const
+{
+	if (_count == 0)
+	{
+		return 0.0f;
+	}
+	float average = getAverageFrameTime();
+	float total = 0.0f;
+	for (int i = 0; i < _count; ++i)
+	{
+		total += (_frames[i] - average) * (_frames[i] - average);
+	}
+	return sqrt(total / _count);
+}
+
+}
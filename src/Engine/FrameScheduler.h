@@ -0,0 +1,63 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace OpenXcom
+{
+
+/**
+ * Paces the main loop. Frames are presented at a steady rate,
+ * independent of the timers that run the game logic, and in
+ * between the loop sleeps until the next frame or timer is due
+ * instead of polling. Also keeps the time between the last
+ * frames presented to work out how steady they are.
+ */
+class FrameScheduler
+{
+public:
+	/// Number of frame times kept.
+	static const int FRAMES = 128;
+private:
+	double _interval, _nextFrame, _lastFrame, _oversleep;
+	float _frames[FRAMES];
+	int _frame, _count;
+public:
+	/// Creates a scheduler with no frame cap.
+	FrameScheduler();
+	/// Cleans up the scheduler.
+	~FrameScheduler();
+	/// Sets the number of frames per second.
+	void setRate(int fps);
+	/// Checks if it's time to present a frame.
+	bool isFrameDue(double now) const;
+	/// Marks a frame as presented.
+	void frameDone(double now);
+	/// Gets when the next frame is due.
+	double getNextFrame() const;
+	/// Sleeps until the given time.
+	void sleepUntil(double time);
+	/// Gets the average time between frames.
+	float getAverageFrameTime() const;
+	/// Gets the longest time between frames.
+	float getWorstFrameTime() const;
+	/// Gets how much the time between frames varies.
+	float getFrameTimeDeviation() const;
+};
+
+}
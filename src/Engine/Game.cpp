@@ -36,8 +36,12 @@
 #include "Action.h"
 #include "Exception.h"
 #include "Options.h"
+#include "Profiler.h"
 #include "CrossPlatform.h"
 #include "FileMap.h"
+#include "FrameScheduler.h"
+#include "Timer.h"
+#include "JobSystem.h"
 #include "Unicode.h"
 #include "../Menu/TestState.h"
 
@@ -51,7 +55,7 @@ const double Game::VOLUME_GRADIENT = 10.0;
  * creates the display screen and sets up the cursor.
  * @param title Title of the game window.
  */
-Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _mouseActive(true), _timeUntilNextFrame(0)
+Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _mouseActive(true), _scheduler(0)
 {
 	Options::reload = false;
 	Options::mute = false;
@@ -75,6 +79,9 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
 		initAudio();
 	}
 
+	// Start the worker threads
+	JobSystem::start(Options::workerThreads);
+
 	// trap the mouse inside the window
 	SDL_WM_GrabInput(Options::captureMouse);
 	
@@ -105,7 +112,7 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
 	// Create blank language
 	_lang = new Language();
 
-	_timeOfLastFrame = 0;
+	_scheduler = new FrameScheduler();
 }
 
 /**
@@ -129,6 +136,9 @@ Game::~Game()
 	delete _mod;
 	delete _screen;
 	delete _fpsCounter;
+	delete _scheduler;
+
+	JobSystem::stop();
 
 	Mix_CloseAudio();
 
@@ -177,6 +187,7 @@ void Game::run()
 		}
 
 		// Process events
+		ProfileTimer eventsTimer(PROFILE_EVENTS);
 		while (SDL_PollEvent(&_event))
 		{
 			if (CrossPlatform::isQuitShortcut(_event))
@@ -287,30 +298,35 @@ void Game::run()
 				break;
 			}
 		}
-		
+		eventsTimer.stop();
+
+		// Finish off work sent back from the worker threads
+		JobSystem::runMainThreadJobs();
+
 		// Process rendering
+		int fps = 0;
 		if (runningState != PAUSED)
 		{
 			// Process logic
+			Timer::resetNextDue();
+			ProfileTimer thinkTimer(PROFILE_THINK);
 			_states.back()->think();
+			thinkTimer.stop();
 			_fpsCounter->think();
 			if (Options::FPS > 0 && !(Options::useOpenGL && Options::vSyncForOpenGL))
 			{
-				// Update our FPS delay time based on the time of the last draw.
-				int fps = SDL_GetAppState() & SDL_APPINPUTFOCUS ? Options::FPS : Options::FPSInactive;
-
-				_timeUntilNextFrame = (1000.0f / fps) - (SDL_GetTicks() - _timeOfLastFrame);
+				fps = SDL_GetAppState() & SDL_APPINPUTFOCUS ? Options::FPS : Options::FPSInactive;
 			}
 			else
 			{
-				_timeUntilNextFrame = 0;
+				fps = 0;
 			}
+			_scheduler->setRate(fps);
 
-			if (_init && _timeUntilNextFrame <= 0)
+			if (_init && _scheduler->isFrameDue(Profiler::getTime()))
 			{
-				// make a note of when this frame update occurred.
-				_timeOfLastFrame = SDL_GetTicks();
 				_fpsCounter->addFrame();
+				ProfileTimer blitTimer(PROFILE_BLIT);
 				_screen->clear();
 				std::list<State*>::iterator i = _states.end();
 				do
@@ -323,23 +339,47 @@ void Game::run()
 				{
 					(*i)->blit();
 				}
+				blitTimer.stop();
 				_fpsCounter->blit(_screen->getSurface());
 				_cursor->blit(_screen->getSurface());
+				ProfileTimer flipTimer(PROFILE_FLIP);
 				_screen->flip();
+				flipTimer.stop();
+				Profiler::endFrame();
+				_scheduler->frameDone(Profiler::getTime());
 			}
 		}
 
 		// Save on CPU
 		switch (runningState)
 		{
-			case RUNNING: 
-				SDL_Delay(1); //Save CPU from going 100%
+			case RUNNING:
+				if (fps == 0)
+				{
+					SDL_Delay(1); //Save CPU from going 100%
+				}
+				else if (_init)
+				{
+					// Sleep until there's something to do, either a frame or a timer
+					double wake = _scheduler->getNextFrame();
+					if (Timer::getNextDue() != 0xFFFFFFFF)
+					{
+						Sint32 timer = (Sint32)(Timer::getNextDue() - SDL_GetTicks());
+						wake = std::min(wake, Profiler::getTime() + std::max(timer, 0) / 1000.0);
+					}
+					_scheduler->sleepUntil(wake);
+				}
 				break;
 			case SLOWED: case PAUSED:
 				SDL_Delay(100); break; //More slowing down.
 		}
 	}
 
+	if (_scheduler->getAverageFrameTime() > 0.0f)
+	{
+		Log(LOG_INFO) << "Frame times: " << _scheduler->getAverageFrameTime() << " ms average, " << _scheduler->getWorstFrameTime() << " ms worst, " << _scheduler->getFrameTimeDeviation() << " ms deviation.";
+	}
+	Profiler::saveTrace();
 	Options::save();
 }
 
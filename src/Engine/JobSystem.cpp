@@ -0,0 +1,528 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "JobSystem.h"
+#include <algorithm>
+#include <thread>
+#include "Logger.h"
+#include "Profiler.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/**
+ * Part of the range of a RangeJob, run as a job of its own.
+ */
+class RangeChunk : public Job
+{
+private:
+	RangeJob *_job;
+	int _begin, _end;
+public:
+	RangeChunk(RangeJob *job, int begin, int end) : _job(job), _begin(begin), _end(end) { }
+	void run() { _job->run(_begin, _end); }
+};
+
+} //namespace
+
+std::vector<JobSystem::Worker*> JobSystem::_workers;
+SDL_mutex *JobSystem::_lock = 0;
+SDL_cond *JobSystem::_wake = 0;
+int JobSystem::_queued = 0;
+size_t JobSystem::_next = 0;
+bool JobSystem::_quit = false;
+std::vector<Job*> JobSystem::_mainJobs;
+double JobSystem::_usageStart = 0.0;
+
+/**
+ * Creates a job that isn't part of any group.
+ */
+Job::Job() : _group(0)
+{
+}
+
+/**
+ *
+ */
+Job::~Job()
+{
+}
+
+/**
+ * Creates a group with no jobs.
+ */
+JobGroup::JobGroup() : _pending(0), _waiting(0)
+{
+}
+
+/**
+ * Waits for any jobs still running, since they report back
+ * to the group when they're done.
+ */
+JobGroup::~JobGroup()
+{
+	wait();
+}
+
+/**
+ * Holds back the jobs of this group until another group is done.
+ * Does nothing if the other group is already done.
+ * @param group Pointer to the group to wait for.
+ */
+void JobGroup::dependOn(JobGroup *group)
+{
+	JobSystem::lock();
+	if (group->_pending > 0)
+	{
+		group->_dependents.push_back(this);
+		_waiting++;
+	}
+	JobSystem::unlock();
+}
+
+/**
+ * Adds a job to the group and queues it, or holds it
+ * if the group is still waiting for others.
+ * @param job Pointer to the job, deleted once it's run.
+ */
+void JobGroup::run(Job *job)
+{
+	job->_group = this;
+	JobSystem::lock();
+	_pending++;
+	if (_waiting > 0)
+	{
+		_held.push_back(job);
+		job = 0;
+	}
+	JobSystem::unlock();
+	if (job != 0)
+	{
+		JobSystem::push(job);
+	}
+}
+
+/**
+ * Checks if all the jobs added to the group have run.
+ * @return True if the group is done.
+ */
+bool JobGroup::isDone() const
+{
+	JobSystem::lock();
+	bool done = (_pending == 0);
+	JobSystem::unlock();
+	return done;
+}
+
+/**
+ * Waits until all the jobs of the group have run. Instead of
+ * sitting idle, the calling thread runs queued jobs meanwhile.
+ */
+void JobGroup::wait()
+{
+	int worker = JobSystem::getCurrentWorker();
+	JobSystem::lock();
+	while (_pending > 0)
+	{
+		if (JobSystem::_queued > 0)
+		{
+			JobSystem::unlock();
+			Job *job = JobSystem::take(worker);
+			if (job != 0)
+			{
+				JobSystem::execute(job);
+			}
+			JobSystem::lock();
+		}
+		else
+		{
+			SDL_CondWait(JobSystem::_wake, JobSystem::_lock);
+		}
+	}
+	JobSystem::unlock();
+}
+
+/**
+ * Locks the queue counter, the groups and the main thread jobs.
+ */
+void JobSystem::lock()
+{
+	if (_lock != 0)
+	{
+		SDL_mutexP(_lock);
+	}
+}
+
+/**
+ * Unlocks the queue counter, the groups and the main thread jobs.
+ */
+void JobSystem::unlock()
+{
+	if (_lock != 0)
+	{
+		SDL_mutexV(_lock);
+	}
+}
+
+/**
+ * Starts the pool of worker threads.
+ * @param threads Number of threads, or 0 for one less than
+ * the number of cores so the main thread has one to itself.
+ */
+void JobSystem::start(int threads)
+{
+	if (threads <= 0)
+	{
+		threads = (int)std::thread::hardware_concurrency() - 1;
+	}
+	_lock = SDL_CreateMutex();
+	_wake = SDL_CreateCond();
+	_quit = false;
+	_usageStart = Profiler::getTime();
+	// all the workers must exist before any starts stealing
+	for (int i = 0; i < threads; ++i)
+	{
+		Worker *worker = new Worker();
+		worker->thread = 0;
+		worker->id = 0;
+		worker->lock = SDL_CreateMutex();
+		worker->busy = 0.0;
+		_workers.push_back(worker);
+	}
+	for (size_t i = 0; i < _workers.size(); ++i)
+	{
+		_workers[i]->thread = SDL_CreateThread(work, (void*)i);
+		if (_workers[i]->thread == 0)
+		{
+			Log(LOG_ERROR) << "Failed to start worker thread: " << SDL_GetError();
+			stop();
+			_lock = SDL_CreateMutex();
+			_wake = SDL_CreateCond();
+			return;
+		}
+		_workers[i]->id = SDL_GetThreadID(_workers[i]->thread);
+	}
+	Log(LOG_INFO) << "Started " << _workers.size() << " worker threads.";
+}
+
+/**
+ * Lets the workers finish the jobs in their queues and stops them.
+ * Jobs left for the main thread are thrown away.
+ */
+void JobSystem::stop()
+{
+	lock();
+	_quit = true;
+	if (_wake != 0)
+	{
+		SDL_CondBroadcast(_wake);
+	}
+	unlock();
+	for (std::vector<Worker*>::iterator i = _workers.begin(); i != _workers.end(); ++i)
+	{
+		if ((*i)->thread != 0)
+		{
+			SDL_WaitThread((*i)->thread, 0);
+		}
+	}
+	for (std::vector<Worker*>::iterator i = _workers.begin(); i != _workers.end(); ++i)
+	{
+		SDL_DestroyMutex((*i)->lock);
+		delete *i;
+	}
+	_workers.clear();
+	for (std::vector<Job*>::iterator i = _mainJobs.begin(); i != _mainJobs.end(); ++i)
+	{
+		delete *i;
+	}
+	_mainJobs.clear();
+	if (_wake != 0)
+	{
+		SDL_DestroyCond(_wake);
+		_wake = 0;
+	}
+	if (_lock != 0)
+	{
+		SDL_DestroyMutex(_lock);
+		_lock = 0;
+	}
+	_queued = 0;
+	_quit = false;
+}
+
+/**
+ * Returns the number of worker threads running.
+ * @return Number of threads.
+ */
+int JobSystem::getWorkers()
+{
+	return (int)_workers.size();
+}
+
+/**
+ * Runs jobs on a worker thread, first from its own queue,
+ * newest first, and then from the others, oldest first.
+ * Sleeps while there's nothing to do.
+ * @param data Index of the worker.
+ * @return Always 0.
+ */
+int JobSystem::work(void *data)
+{
+	int index = (int)(size_t)data;
+	Worker *worker = _workers[index];
+	for (;;)
+	{
+		Job *job = take(index);
+		if (job != 0)
+		{
+			double start = Profiler::getTime();
+			execute(job);
+			double time = Profiler::getTime() - start;
+			SDL_mutexP(worker->lock);
+			worker->busy += time;
+			SDL_mutexV(worker->lock);
+			continue;
+		}
+		lock();
+		while (!_quit && _queued == 0)
+		{
+			SDL_CondWait(_wake, _lock);
+		}
+		bool quit = (_quit && _queued == 0);
+		unlock();
+		if (quit)
+		{
+			return 0;
+		}
+	}
+}
+
+/**
+ * Finds which worker is running the current thread.
+ * @return Index of the worker, or -1 if it's not a worker thread.
+ */
+int JobSystem::getCurrentWorker()
+{
+	Uint32 id = SDL_ThreadID();
+	for (size_t i = 0; i < _workers.size(); ++i)
+	{
+		if (_workers[i]->id == id)
+		{
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Queues a job. Jobs queued by a worker go on its own queue,
+ * the rest are spread over the workers in turn.
+ * @param job Pointer to the job.
+ */
+void JobSystem::push(Job *job)
+{
+	if (_workers.empty())
+	{
+		execute(job);
+		return;
+	}
+	int index = getCurrentWorker();
+	if (index < 0)
+	{
+		lock();
+		index = (int)(_next++ % _workers.size());
+		unlock();
+	}
+	Worker *worker = _workers[index];
+	SDL_mutexP(worker->lock);
+	worker->jobs.push_back(job);
+	SDL_mutexV(worker->lock);
+
+	lock();
+	_queued++;
+	SDL_CondBroadcast(_wake);
+	unlock();
+}
+
+/**
+ * Takes a job off the queues, starting with the given worker's
+ * own queue and then stealing from the rest.
+ * @param index Index of the worker, or -1 for other threads.
+ * @return Pointer to the job, or 0 if the queues are empty.
+ */
+Job *JobSystem::take(int index)
+{
+	size_t start = (index < 0) ? 0 : (size_t)index;
+	for (size_t i = 0; i < _workers.size(); ++i)
+	{
+		Worker *worker = _workers[(start + i) % _workers.size()];
+		Job *job = 0;
+		SDL_mutexP(worker->lock);
+		if (!worker->jobs.empty())
+		{
+			if (index >= 0 && i == 0)
+			{
+				job = worker->jobs.back();
+				worker->jobs.pop_back();
+			}
+			else
+			{
+				job = worker->jobs.front();
+				worker->jobs.pop_front();
+			}
+		}
+		SDL_mutexV(worker->lock);
+		if (job != 0)
+		{
+			lock();
+			_queued--;
+			unlock();
+			return job;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Runs a job, deletes it and lets its group know. When the group
+ * is done, the jobs held back by groups waiting for it are queued.
+ * @param job Pointer to the job.
+ */
+void JobSystem::execute(Job *job)
+{
+	JobGroup *group = job->_group;
+	job->run();
+	delete job;
+	if (group == 0)
+	{
+		return;
+	}
+
+	std::vector<Job*> released;
+	lock();
+	if (--group->_pending == 0)
+	{
+		for (std::vector<JobGroup*>::iterator i = group->_dependents.begin(); i != group->_dependents.end(); ++i)
+		{
+			if (--(*i)->_waiting == 0)
+			{
+				released.insert(released.end(), (*i)->_held.begin(), (*i)->_held.end());
+				(*i)->_held.clear();
+			}
+		}
+		group->_dependents.clear();
+		if (_wake != 0)
+		{
+			SDL_CondBroadcast(_wake);
+		}
+	}
+	unlock();
+	for (std::vector<Job*>::iterator i = released.begin(); i != released.end(); ++i)
+	{
+		push(*i);
+	}
+}
+
+/**
+ * Runs a job on one of the worker threads, without waiting for it.
+ * @param job Pointer to the job, deleted once it's run.
+ */
+void JobSystem::run(Job *job)
+{
+	push(job);
+}
+
+/**
+ * Runs a job on the main thread the next time it goes
+ * through the game loop, for work that has to use SDL.
+ * @param job Pointer to the job, deleted once it's run.
+ */
+void JobSystem::runOnMainThread(Job *job)
+{
+	lock();
+	_mainJobs.push_back(job);
+	unlock();
+}
+
+/**
+ * Runs all the jobs sent to the main thread so far.
+ * Must only be called from the main thread.
+ */
+void JobSystem::runMainThreadJobs()
+{
+	std::vector<Job*> jobs;
+	lock();
+	jobs.swap(_mainJobs);
+	unlock();
+	for (std::vector<Job*>::iterator i = jobs.begin(); i != jobs.end(); ++i)
+	{
+		execute(*i);
+	}
+}
+
+/**
+ * Splits a range into pieces and runs a job over them on all
+ * the threads, including the calling one, until they're all done.
+ * @param job Pointer to the job, which stays with the caller.
+ * @param begin Start of the range.
+ * @param end End of the range (not included).
+ * @param grain Size of each piece.
+ */
+void JobSystem::parallelFor(RangeJob *job, int begin, int end, int grain)
+{
+	if (_workers.empty() || end - begin <= grain)
+	{
+		if (begin < end)
+		{
+			job->run(begin, end);
+		}
+		return;
+	}
+	JobGroup group;
+	for (int i = begin; i < end; i += grain)
+	{
+		group.run(new RangeChunk(job, i, std::min(i + grain, end)));
+	}
+	group.wait();
+}
+
+/**
+ * Gets the share of time each worker spent running jobs
+ * since the last time this was called.
+ * @param usage List to fill with a value from 0 to 1 per worker.
+ */
+void JobSystem::getUtilization(std::vector<float> &usage)
+{
+	double now = Profiler::getTime();
+	double elapsed = now - _usageStart;
+	_usageStart = now;
+	usage.clear();
+	for (std::vector<Worker*>::iterator i = _workers.begin(); i != _workers.end(); ++i)
+	{
+		SDL_mutexP((*i)->lock);
+		double busy = (*i)->busy;
+		(*i)->busy = 0.0;
+		SDL_mutexV((*i)->lock);
+		usage.push_back(elapsed > 0.0 ? (float)std::min(1.0, busy / elapsed) : 0.0f);
+	}
+}
+
+}
@@ -0,0 +1,152 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <deque>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+namespace OpenXcom
+{
+
+class JobGroup;
+
+/**
+ * A piece of work that can be run on any of the job system's threads.
+ * Jobs are deleted by the job system once they've run.
+ */
+class Job
+{
+private:
+	JobGroup *_group;
+	friend class JobSystem;
+	friend class JobGroup;
+public:
+	/// Creates a job.
+	Job();
+	/// Cleans up the job.
+	virtual ~Job();
+	/// Does the work.
+	virtual void run() = 0;
+};
+
+/**
+ * Work split over a range of numbers, such as the rows of a surface,
+ * for JobSystem::parallelFor. The same object is run on several
+ * threads at once, so each call must only touch its own part.
+ */
+class RangeJob
+{
+public:
+	/// Cleans up the job.
+	virtual ~RangeJob() {}
+	/// Does the work for part of the range.
+	virtual void run(int begin, int end) = 0;
+};
+
+/**
+ * A set of jobs that can be waited on together. A group can depend on
+ * other groups, in which case its jobs are held back until all of them
+ * are done, so the jobs of a group should be added before anything
+ * depends on it.
+ */
+class JobGroup
+{
+private:
+	int _pending, _waiting;
+	std::vector<Job*> _held;
+	std::vector<JobGroup*> _dependents;
+	friend class JobSystem;
+public:
+	/// Creates an empty group.
+	JobGroup();
+	/// Waits for the group and cleans it up.
+	~JobGroup();
+	/// Holds the group's jobs until another group is done.
+	void dependOn(JobGroup *group);
+	/// Adds a job to the group.
+	void run(Job *job);
+	/// Checks if all the group's jobs are done.
+	bool isDone() const;
+	/// Waits for all the group's jobs, helping run them.
+	void wait();
+};
+
+/**
+ * Runs jobs on a pool of worker threads that lives as long as the game.
+ * Each worker has its own queue and takes jobs from the others when
+ * it runs out. SDL isn't thread-safe, so anything that touches it
+ * has to be sent back to the main thread with runOnMainThread.
+ * With no workers, jobs are run right away on the calling thread.
+ */
+class JobSystem
+{
+private:
+	struct Worker
+	{
+		SDL_Thread *thread;
+		Uint32 id;
+		SDL_mutex *lock;
+		std::deque<Job*> jobs;
+		double busy;
+	};
+	static std::vector<Worker*> _workers;
+	static SDL_mutex *_lock;
+	static SDL_cond *_wake;
+	static int _queued;
+	static size_t _next;
+	static bool _quit;
+	static std::vector<Job*> _mainJobs;
+	static double _usageStart;
+	friend class JobGroup;
+
+	/// Locks the job system's shared state.
+	static void lock();
+	/// Unlocks the job system's shared state.
+	static void unlock();
+	/// Runs jobs on a worker thread.
+	static int work(void *data);
+	/// Gets the worker running on this thread.
+	static int getCurrentWorker();
+	/// Queues a job for the workers.
+	static void push(Job *job);
+	/// Takes the next job to run.
+	static Job *take(int worker);
+	/// Runs a job and marks it done.
+	static void execute(Job *job);
+public:
+	/// Starts the worker threads.
+	static void start(int threads);
+	/// Finishes the queued jobs and stops the worker threads.
+	static void stop();
+	/// Gets the number of worker threads.
+	static int getWorkers();
+	/// Runs a job on a worker thread.
+	static void run(Job *job);
+	/// Runs a job on the main thread.
+	static void runOnMainThread(Job *job);
+	/// Runs the jobs sent to the main thread.
+	static void runMainThreadJobs();
+	/// Runs some work over a range on all the threads.
+	static void parallelFor(RangeJob *job, int begin, int end, int grain);
+	/// Gets how busy each worker was since the last call.
+	static void getUtilization(std::vector<float> &usage);
+};
+
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MappedFile.h"
+#include <fstream>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif !defined(__MORPHOS__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a view with no file in it.
+ */
+MappedFile::MappedFile() : _data(0), _size(0), _handle(0), _open(false), _mapped(false)
+{
+}
+
+/**
+ * Unmaps the file, if there's one.
+ */
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+/**
+ * Maps the contents of a file into memory. Empty files
+ * can't be mapped, so they're opened with no data.
+ * @param path Full path to the file.
+ * @return True if the file was opened.
+ */
+bool MappedFile::open(const std::string &path)
+{
+	close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || (Uint64)size.QuadPart > (size_t)-1)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	if (size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		_open = true;
+		return true;
+	}
+	HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+	// the mapping keeps the file open
+	CloseHandle(file);
+	if (mapping == 0)
+	{
+		return false;
+	}
+	void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == 0)
+	{
+		CloseHandle(mapping);
+		return false;
+	}
+	_handle = mapping;
+	_data = (Uint8*)data;
+	_size = (size_t)size.QuadPart;
+	_open = true;
+	_mapped = true;
+#elif defined(__MORPHOS__)
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	file.seekg(0, std::ios::end);
+	std::streamoff size = file.tellg();
+	file.seekg(0, std::ios::beg);
+	if (size < 0)
+	{
+		return false;
+	}
+	_open = true;
+	if (size == 0)
+	{
+		return true;
+	}
+	_data = new Uint8[(size_t)size];
+	_size = (size_t)size;
+	if (!file.read((char*)_data, size))
+	{
+		close();
+		return false;
+	}
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+	{
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+	{
+		::close(fd);
+		return false;
+	}
+	if (info.st_size == 0)
+	{
+		::close(fd);
+		_open = true;
+		return true;
+	}
+	void *data = mmap(0, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps the file open
+	::close(fd);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+	_data = (Uint8*)data;
+	_size = (size_t)info.st_size;
+	_open = true;
+	_mapped = true;
+#endif
+	return true;
+}
+
+/**
+ * Unmaps the file. Any pointers into it are no longer valid.
+ */
+void MappedFile::close()
+{
+	if (_data == 0)
+	{
+		_open = false;
+		return;
+	}
+	if (_mapped)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(_data);
+		CloseHandle((HANDLE)_handle);
+#elif !defined(__MORPHOS__)
+		munmap(_data, _size);
+#endif
+	}
+	else
+	{
+		delete[] _data;
+	}
+	_data = 0;
+	_size = 0;
+	_handle = 0;
+	_open = false;
+	_mapped = false;
+}
+
+/**
+ * Checks if there's a file in the view.
+ * @return True if a file is mapped.
+ */
+bool MappedFile::isOpen() const
+{
+	return _open;
+}
+
+/**
+ * Gets the contents of the file. They're read-only,
+ * writing to them will crash.
+ * @return Pointer to the file's data, or 0 if there's none.
+ */
+const Uint8 *MappedFile::getData() const
+{
+	return _data;
+}
+
+/**
+ * Gets the size of the mapped file.
+ * @return Size in bytes.
+ */
+size_t MappedFile::getSize() const
+{
+	return _size;
+}
+
+}
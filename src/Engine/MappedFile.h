@@ -0,0 +1,62 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Read-only view of a whole file mapped into memory,
+ * so the OS pages it in as it's used instead of it being
+ * read up front. Platforms without file mapping get the
+ * file read into memory instead.
+ */
+class MappedFile
+{
+private:
+	Uint8 *_data;
+	size_t _size;
+	void *_handle;
+	bool _open, _mapped;
+
+	/// Stops copying, the view can't be shared.
+	MappedFile(const MappedFile&);
+	/// Stops copying, the view can't be shared.
+	MappedFile &operator=(const MappedFile&);
+public:
+	/// Creates a closed file view.
+	MappedFile();
+	/// Unmaps the file.
+	~MappedFile();
+	/// Maps a file into memory.
+	bool open(const std::string &path);
+	/// Unmaps the file.
+	void close();
+	/// Checks if a file is mapped.
+	bool isOpen() const;
+	/// Gets the contents of the file.
+	const Uint8 *getData() const;
+	/// Gets the size of the file.
+	size_t getSize() const;
+};
+
+}
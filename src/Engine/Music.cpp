@@ -108,7 +108,7 @@ void Music::stop()
 #ifndef __NO_MUSIC
 	if (!Options::mute)
 	{
-		func_mute();
+		AdlibMusic::mute();
 		Mix_HookMusic(NULL, NULL);
 		Mix_HaltMusic();
 	}
@@ -140,7 +140,7 @@ void Music::resume()
 	{
 		Mix_ResumeMusic();
 		if (Mix_GetMusicType(0) == MUS_NONE)
-			Mix_HookMusic(AdlibMusic::player, NULL);
+			Mix_HookMusic(Options::cacheAdlibMusic ? AdlibMusic::cachedPlayer : AdlibMusic::player, NULL);
 	}
 #endif
 }
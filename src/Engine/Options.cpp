@@ -53,6 +53,7 @@ std::map<std::string, std::string> _commandLine;
 std::vector<OptionInfo> _info;
 std::map<std::string, ModInfo> _modInfos;
 std::string _masterMod;
+std::string _replay;
 
 /**
  * Sets up the options by creating their OptionInfo metadata.
@@ -75,6 +76,7 @@ void create()
 
 	_info.push_back(OptionInfo("maxFrameSkip", &maxFrameSkip, 0));
 	_info.push_back(OptionInfo("traceAI", &traceAI, false));
+	_info.push_back(OptionInfo("battleRecordReplay", &battleRecordReplay, false));
 	_info.push_back(OptionInfo("verboseLogging", &verboseLogging, false));
 	_info.push_back(OptionInfo("StereoSound", &StereoSound, true));
 	//_info.push_back(OptionInfo("baseXResolution", &baseXResolution, Screen::ORIGINAL_WIDTH));
@@ -109,6 +111,9 @@ void create()
 	_info.push_back(OptionInfo("battleAlienSpeed", &battleAlienSpeed, 30));
 	_info.push_back(OptionInfo("battleNewPreviewPath", (int*)&battleNewPreviewPath, PATH_NONE)); // requires double-click to confirm moves
 	_info.push_back(OptionInfo("fpsCounter", &fpsCounter, false));
+	_info.push_back(OptionInfo("profiler", &profiler, false));
+	_info.push_back(OptionInfo("profilerTrace", &profilerTrace, false));
+	_info.push_back(OptionInfo("workerThreads", &workerThreads, 0)); // 0 = one less than the number of cores
 	_info.push_back(OptionInfo("globeDetail", &globeDetail, true));
 	_info.push_back(OptionInfo("globeRadarLines", &globeRadarLines, true));
 	_info.push_back(OptionInfo("globeFlightPaths", &globeFlightPaths, true));
@@ -140,6 +145,8 @@ void create()
 	_info.push_back(OptionInfo("preferredVideo", (int*)&preferredVideo, VIDEO_FMV));
 	_info.push_back(OptionInfo("wordwrap", (int*)&wordwrap, WRAP_AUTO));
 	_info.push_back(OptionInfo("musicAlwaysLoop", &musicAlwaysLoop, false));
+	_info.push_back(OptionInfo("cacheAdlibMusic", &cacheAdlibMusic, false));
+	_info.push_back(OptionInfo("cacheSounds", &cacheSounds, false));
 	_info.push_back(OptionInfo("touchEnabled", &touchEnabled, false));
 	_info.push_back(OptionInfo("rootWindowedMode", &rootWindowedMode, false));
 	_info.push_back(OptionInfo("lazyLoadResources", &lazyLoadResources, true));
@@ -390,6 +397,10 @@ void loadArgs(int argc, char *argv[])
 				{
 					_masterMod = argv[i];
 				}
+				else if (argname == "replay")
+				{
+					_replay = argv[i];
+				}
 				else
 				{
 					//save this command line option for now, we will apply it later
@@ -422,6 +433,8 @@ bool showHelp(int argc, char *argv[])
 	help << "        use PATH as the default Config Folder instead of auto-detecting" << std::endl << std::endl;
 	help << "-master MOD" << std::endl;
 	help << "        set MOD to the current master mod (eg. -master xcom2)" << std::endl << std::endl;
+	help << "-replay NAME" << std::endl;
+	help << "        play back the battle recorded in NAME.replay in the User Folder and log the results" << std::endl << std::endl;
 	help << "-KEY VALUE" << std::endl;
 	help << "        override option KEY with VALUE (eg. -displayWidth 640)" << std::endl << std::endl;
 	help << "-help" << std::endl;
@@ -726,6 +739,15 @@ std::string getActiveMaster()
 	return _masterMod;
 }
 
+/**
+ * Gets the battle replay to play back, as given on the command line.
+ * @return Replay name, or empty if none.
+ */
+const std::string &getReplay()
+{
+	return _replay;
+}
+
 static void _loadMod(const ModInfo &modInfo, std::set<std::string> circDepCheck)
 {
 	if (circDepCheck.end() != circDepCheck.find(modInfo.getId()))
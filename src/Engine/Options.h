@@ -102,6 +102,8 @@ namespace Options
 	void switchDisplay();
 	/// returns the id of the active master mod
 	std::string getActiveMaster();
+	/// Gets the battle replay to play back.
+	const std::string &getReplay();
 	/// Maps resources in active mods to the virtual file system
 	void mapResources();
 	/// Gets the map of mod ids to mod infos
@@ -0,0 +1,259 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+#include <fstream>
+#include <chrono>
+#include "Logger.h"
+#include "Options.h"
+
+namespace OpenXcom
+{
+
+bool Profiler::_enabled = false;
+bool Profiler::_totals = false;
+double Profiler::_epoch = 0.0;
+double Profiler::_current[PROFILE_SECTIONS] = {};
+float Profiler::_frames[Profiler::FRAMES][PROFILE_SECTIONS] = {};
+int Profiler::_frame = 0;
+double Profiler::_total[PROFILE_SECTIONS] = {};
+unsigned int Profiler::_calls[PROFILE_SECTIONS] = {};
+std::vector<Profiler::Event> Profiler::_events;
+
+/**
+ * Turns the timers on if the profiler or the trace
+ * are shown, or something wants the total times.
+ */
+void Profiler::update()
+{
+	_enabled = Options::profiler || Options::profilerTrace || _totals;
+}
+
+/**
+ * Gets the name of a section, for the logs and traces.
+ * @param section Section of the game.
+ * @return Name of the section.
+ */
+const char *Profiler::getName(ProfileSection section)
+{
+	static const char *names[PROFILE_SECTIONS] = { "Events", "Think", "Blit", "Flip", "Scale", "Globe", "Terrain", "FOV", "Lighting", "Pathfinding", "AI", "Explosions" };
+	return names[section];
+}
+
+/**
+ * Checks if a section is one of the steps of the main loop,
+ * so it doesn't overlap any other top level section.
+ * @param section Section of the game.
+ * @return True if it's part of the main loop.
+ */
+bool Profiler::isTopLevel(ProfileSection section)
+{
+	return section <= PROFILE_FLIP;
+}
+
+/**
+ * Gets the current time for the section timers.
+ * @return Time in seconds.
+ */
+double Profiler::getTime()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Adds some time spent in a section of the game to the
+ * current frame, the totals and the trace.
+ * @param section Section of the game.
+ * @param start Time the section started, in seconds.
+ * @param end Time the section ended, in seconds.
+ */
+void Profiler::add(ProfileSection section, double start, double end)
+{
+	double duration = end - start;
+	_current[section] += duration;
+	if (_totals)
+	{
+		_total[section] += duration;
+		_calls[section]++;
+	}
+	if (Options::profilerTrace && _events.size() < MAX_EVENTS)
+	{
+		if (_events.empty())
+		{
+			_epoch = start;
+		}
+		Event event;
+		event.section = section;
+		event.start = start - _epoch;
+		event.duration = duration;
+		_events.push_back(event);
+	}
+}
+
+/**
+ * Stores the times of the frame that was just drawn and starts
+ * a new one. A finished trace is saved when it's turned off.
+ */
+void Profiler::endFrame()
+{
+	for (int i = 0; i < PROFILE_SECTIONS; ++i)
+	{
+		_frames[_frame][i] = (float)(_current[i] * 1000.0);
+		_current[i] = 0.0;
+	}
+	_frame = (_frame + 1) % FRAMES;
+	if (!Options::profilerTrace && !_events.empty())
+	{
+		saveTrace();
+	}
+	update();
+}
+
+/**
+ * Gets the time spent in a section in one of the past frames.
+ * @param frame Frame, from 0 (oldest) to FRAMES - 1 (newest).
+ * @param section Section of the game.
+ * @return Time in milliseconds.
+ */
+float Profiler::getFrameTime(int frame, ProfileSection section)
+{
+	return _frames[(_frame + frame) % FRAMES][section];
+}
+
+/**
+ * Gets the average time spent in a section over the past frames.
+ * @param section Section of the game.
+ * @return Time in milliseconds.
+ */
+float Profiler::getAverageTime(ProfileSection section)
+{
+	float total = 0.0f;
+	for (int i = 0; i < FRAMES; ++i)
+	{
+		total += _frames[i][section];
+	}
+	return total / FRAMES;
+}
+
+/**
+ * Starts adding up the total time spent in every section,
+ * from zero, or stops doing it.
+ * @param totals True to add up the totals.
+ */
+void Profiler::setTotals(bool totals)
+{
+	if (totals)
+	{
+		for (int i = 0; i < PROFILE_SECTIONS; ++i)
+		{
+			_total[i] = 0.0;
+			_calls[i] = 0;
+		}
+	}
+	_totals = totals;
+	update();
+}
+
+/**
+ * Gets the total time spent in a section since the totals were started.
+ * @param section Section of the game.
+ * @return Time in seconds.
+ */
+double Profiler::getTotalTime(ProfileSection section)
+{
+	return _total[section];
+}
+
+/**
+ * Gets the number of times a section was timed since the totals were started.
+ * @param section Section of the game.
+ * @return Number of calls.
+ */
+unsigned int Profiler::getTotalCalls(ProfileSection section)
+{
+	return _calls[section];
+}
+
+/**
+ * Saves every section timed since the trace was turned on
+ * to trace.json in the user folder, in the Chrome trace event
+ * format, and starts a new trace.
+ */
+void Profiler::saveTrace()
+{
+	if (_events.empty())
+	{
+		return;
+	}
+	std::string filename = Options::getUserFolder() + "trace.json";
+	std::ofstream out(filename.c_str());
+	if (!out)
+	{
+		Log(LOG_WARNING) << "Failed to save " << filename;
+		_events.clear();
+		return;
+	}
+	out << "{\"traceEvents\":[\n";
+	for (std::vector<Event>::const_iterator i = _events.begin(); i != _events.end(); ++i)
+	{
+		if (i != _events.begin())
+		{
+			out << ",\n";
+		}
+		out << "{\"name\":\"" << getName(i->section) << "\",\"cat\":\"" << (isTopLevel(i->section) ? "frame" : "game") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,";
+		out << "\"ts\":" << (long long)(i->start * 1000000.0) << ",\"dur\":" << (long long)(i->duration * 1000000.0) << "}";
+	}
+	out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	Log(LOG_INFO) << "Saved " << _events.size() << " timings to " << filename;
+	_events.clear();
+}
+
+/**
+ * Starts timing a section of the game.
+ * @param section Section of the game.
+ */
+ProfileTimer::ProfileTimer(ProfileSection section) : _section(section), _start(0.0)
+{
+	if (Profiler::isEnabled())
+	{
+		_start = Profiler::getTime();
+	}
+}
+
+/**
+ * Adds the time spent to the profiler.
+ */
+ProfileTimer::~ProfileTimer()
+{
+	stop();
+}
+
+/**
+ * Adds the time spent so far to the profiler,
+ * for sections that end before the scope does.
+ */
+void ProfileTimer::stop()
+{
+	if (_start != 0.0)
+	{
+		Profiler::add(_section, _start, Profiler::getTime());
+		_start = 0.0;
+	}
+}
+
+}
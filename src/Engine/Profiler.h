@@ -0,0 +1,108 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * Parts of the game that are timed by the profiler.
+ * The first few make up the main loop, the rest happen inside them.
+ */
+enum ProfileSection { PROFILE_EVENTS, PROFILE_THINK, PROFILE_BLIT, PROFILE_FLIP, PROFILE_SCALE, PROFILE_GLOBE, PROFILE_TERRAIN, PROFILE_FOV, PROFILE_LIGHTING, PROFILE_PATHFINDING, PROFILE_AI, PROFILE_EXPLODE, PROFILE_SECTIONS };
+
+/**
+ * Adds up the time spent in each part of the game every frame,
+ * keeping the last few frames for the FPS counter to show and
+ * optionally a trace of every section timed for offline analysis.
+ * Nothing is timed unless the profiler, the trace or the totals
+ * are turned on.
+ */
+class Profiler
+{
+public:
+	/// Number of frames kept.
+	static const int FRAMES = 128;
+	/// Maximum number of sections kept in a trace.
+	static const size_t MAX_EVENTS = 1 << 20;
+private:
+	struct Event
+	{
+		ProfileSection section;
+		double start, duration;
+	};
+	static bool _enabled, _totals;
+	static double _epoch;
+	static double _current[PROFILE_SECTIONS];
+	static float _frames[FRAMES][PROFILE_SECTIONS];
+	static int _frame;
+	static double _total[PROFILE_SECTIONS];
+	static unsigned int _calls[PROFILE_SECTIONS];
+	static std::vector<Event> _events;
+
+	/// Checks if anything needs timing.
+	static void update();
+public:
+	/// Is anything being timed?
+	static bool isEnabled() { return _enabled; }
+	/// Gets the name of a section.
+	static const char *getName(ProfileSection section);
+	/// Is the section part of the main loop?
+	static bool isTopLevel(ProfileSection section);
+	/// Gets the current time.
+	static double getTime();
+	/// Adds time spent in a section.
+	static void add(ProfileSection section, double start, double end);
+	/// Moves on to the next frame.
+	static void endFrame();
+	/// Gets the time spent in a section in a past frame.
+	static float getFrameTime(int frame, ProfileSection section);
+	/// Gets the average time spent in a section over the past frames.
+	static float getAverageTime(ProfileSection section);
+	/// Starts or stops adding up total times.
+	static void setTotals(bool totals);
+	/// Gets the total time spent in a section.
+	static double getTotalTime(ProfileSection section);
+	/// Gets the number of times a section was timed.
+	static unsigned int getTotalCalls(ProfileSection section);
+	/// Saves the trace to the user folder.
+	static void saveTrace();
+};
+
+/**
+ * Times a section of the game for as long as it's in scope,
+ * if the profiler is enabled.
+ */
+class ProfileTimer
+{
+private:
+	ProfileSection _section;
+	double _start;
+public:
+	/// Starts timing a section.
+	ProfileTimer(ProfileSection section);
+	/// Stops timing the section.
+	~ProfileTimer();
+	/// Stops timing the section early.
+	void stop();
+};
+
+}
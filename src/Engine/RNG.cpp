@@ -41,14 +41,110 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
    rather suggest to use a xorshift128+ (for maximum speed) or
    xorshift1024* (for speed and very long period) generator. */
 
-uint64_t x = time(0); /* The state must be seeded with a nonzero value. */
+/* The state must be seeded with a nonzero value. */
+Stream global(time(0));
 
-uint64_t next()
+/**
+ * Mixes up the bits of a number so nearby numbers end up far apart
+ * (the SplitMix64 finalizer, also by Sebastiano Vigna).
+ * @param z Number to mix.
+ * @return Mixed number.
+ */
+static uint64_t mix(uint64_t z)
+{
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/**
+ * Creates a stream starting from a seed.
+ * @param seed Initial state, must be nonzero.
+ */
+Stream::Stream(uint64_t seed) : _state(seed)
+{
+}
+
+/**
+ * Returns the current state of the stream.
+ * @return Current seed.
+ */
+uint64_t Stream::getSeed() const
+{
+	return _state;
+}
+
+/**
+ * Changes the current state of the stream.
+ * @param n New seed.
+ */
+void Stream::setSeed(uint64_t n)
+{
+	_state = n;
+}
+
+/**
+ * Advances the stream and returns the next number.
+ * @return Raw 64-bit number.
+ */
+uint64_t Stream::next()
+{
+	_state ^= _state >> 12; // a
+	_state ^= _state << 25; // b
+	_state ^= _state >> 27; // c
+	return _state * 2685821657736338717ULL;
+}
+
+/**
+ * Generates a random integer number within a certain range.
+ * @param min Minimum number, inclusive.
+ * @param max Maximum number, inclusive.
+ * @return Generated number.
+ */
+int Stream::generate(int min, int max)
 {
-	x ^= x >> 12; // a
-	x ^= x << 25; // b
-	x ^= x >> 27; // c
-	return x * 2685821657736338717ULL;
+	uint64_t num = next();
+	return (int)(num % (max - min + 1) + min);
+}
+
+/**
+ * Generates a random decimal number within a certain range.
+ * @param min Minimum number.
+ * @param max Maximum number.
+ * @return Generated number.
+ */
+double Stream::generate(double min, double max)
+{
+	double num = next();
+	return (num / ((double)UINT64_MAX / (max - min)) + min);
+}
+
+/**
+ * Generates a random percent chance of an event occurring,
+ * and returns the result
+ * @param value Value percentage (0-100%)
+ * @return True if the chance succeeded.
+ */
+bool Stream::percent(int value)
+{
+	return (generate(0, 99) < value);
+}
+
+/**
+ * Creates a new stream from the current state of this one and a key,
+ * without advancing this one. Different keys give unrelated streams,
+ * and the same key always gives the same stream.
+ * @param key Number identifying the new stream, eg. a unit ID.
+ * @return New stream.
+ */
+Stream Stream::split(uint64_t key) const
+{
+	uint64_t seed = mix(_state ^ mix(key + 0x9e3779b97f4a7c15ULL));
+	if (seed == 0)
+	{
+		seed = 0x9e3779b97f4a7c15ULL;
+	}
+	return Stream(seed);
 }
 
 /**
@@ -57,7 +153,7 @@ uint64_t next()
  */
 uint64_t getSeed()
 {
-	return x;
+	return global.getSeed();
 }
 
 /**
@@ -66,7 +162,7 @@ uint64_t getSeed()
  */
 void setSeed(uint64_t n)
 {
-	x = n;
+	global.setSeed(n);
 }
 
 /**
@@ -77,8 +173,7 @@ void setSeed(uint64_t n)
  */
 int generate(int min, int max)
 {
-	uint64_t num = next();
-	return (int)(num % (max - min + 1) + min);
+	return global.generate(min, max);
 }
 
 /**
@@ -89,8 +184,7 @@ int generate(int min, int max)
  */
 double generate(double min, double max)
 {
-	double num = next();
-	return (num / ((double)UINT64_MAX / (max - min)) + min);
+	return global.generate(min, max);
 }
 
 /**
@@ -113,7 +207,19 @@ int seedless(int min, int max)
  */
 bool percent(int value)
 {
-	return (generate(0, 99) < value);
+	return global.percent(value);
+}
+
+/**
+ * Creates a new stream from the current state of the global
+ * generator and a key, without advancing it, so the numbers
+ * drawn by the rest of the game stay the same.
+ * @param key Number identifying the new stream.
+ * @return New stream.
+ */
+Stream split(uint64_t key)
+{
+	return global.split(key);
 }
 
 }
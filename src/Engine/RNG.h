@@ -29,9 +29,52 @@ namespace OpenXcom
  * Random Number Generator used throughout the game
  * for all your randomness needs. Uses a 64-bit xorshift
  * pseudorandom number generator.
+ * The global functions all draw from one generator. Parts of the
+ * game that need their own numbers, such as work running on other
+ * threads, can split a Stream off it instead.
  */
 namespace RNG
 {
+	/**
+	 * A generator with its own state, owned by whatever draws from it.
+	 * Streams split off another with the same key always get the
+	 * same state, so they're as deterministic as the global generator.
+	 */
+	class Stream
+	{
+	private:
+		uint64_t _state;
+	public:
+		/// Creates a stream from a seed.
+		explicit Stream(uint64_t seed);
+		/// Gets the state of the stream.
+		uint64_t getSeed() const;
+		/// Sets the state of the stream.
+		void setSeed(uint64_t n);
+		/// Generates the next raw number.
+		uint64_t next();
+		/// Generates a random integer number, inclusive.
+		int generate(int min, int max);
+		/// Generates a random floating-point number.
+		double generate(double min, double max);
+		/// Generates a percentage chance.
+		bool percent(int value);
+		/// Creates a new stream derived from this one.
+		Stream split(uint64_t key) const;
+		/**
+		 * Randomly changes the orders of the elements in a list.
+		 * @param list The container to randomize.
+		 */
+		template <typename T>
+		void shuffle(std::vector<T> &list)
+		{
+			if (list.empty())
+				return;
+			for (size_t i = list.size() - 1; i > 0; --i)
+				std::swap(list[i], list[generate(0, i)]);
+		}
+	};
+
 	/// Gets the seed in use.
 	uint64_t getSeed();
 	/// Sets the seed in use.
@@ -44,6 +87,8 @@ namespace RNG
 	int seedless(int min, int max);
 	/// Generates a percentage chance.
 	bool percent(int value);
+	/// Creates a new stream derived from the global generator.
+	Stream split(uint64_t key);
 	/// Shuffles a list randomly.
 	/**
 	 * Randomly changes the orders of the elements in a list.
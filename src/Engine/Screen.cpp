@@ -33,6 +33,7 @@
 #include "FileMap.h"
 #include "Zoom.h"
 #include "Timer.h"
+#include "Profiler.h"
 #include <SDL.h>
 
 namespace OpenXcom
@@ -189,6 +190,7 @@ void Screen::flip()
 {
 	if (getWidth() != _baseWidth || getHeight() != _baseHeight || useOpenGL())
 	{
+		ProfileTimer timer(PROFILE_SCALE);
 		Zoom::flipWithZoom(_surface->getSurface(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
 	}
 	else
@@ -21,6 +21,9 @@
 #include "Options.h"
 #include "Logger.h"
 #include "Unicode.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <cstring>
 
 namespace OpenXcom
 {
@@ -28,7 +31,7 @@ namespace OpenXcom
 /**
  * Initializes a new sound effect.
  */
-Sound::Sound() : _sound(0)
+Sound::Sound() : _sound(0), _cache(0)
 {
 }
 
@@ -36,8 +39,20 @@ Sound::Sound() : _sound(0)
  * Deletes the loaded sound content.
  */
 Sound::~Sound()
+{
+	unload();
+}
+
+/**
+ * Frees the loaded sound content. The chunk has to go
+ * before the cache file it points into.
+ */
+void Sound::unload()
 {
 	Mix_FreeChunk(_sound);
+	_sound = 0;
+	delete _cache;
+	_cache = 0;
 }
 
 /**
@@ -47,12 +62,14 @@ Sound::~Sound()
 void Sound::load(const std::string &filename)
 {
 	std::string utf8 = Unicode::convPathToUtf8(filename);
-	_sound = Mix_LoadWAV(utf8.c_str());
-	if (_sound == 0)
+	Mix_Chunk *sound = Mix_LoadWAV(utf8.c_str());
+	if (sound == 0)
 	{
 		std::string err = filename + ":" + Mix_GetError();
 		throw Exception(err);
 	}
+	unload();
+	_sound = sound;
 }
 
 /**
@@ -63,11 +80,82 @@ void Sound::load(const std::string &filename)
 void Sound::load(const void *data, unsigned int size)
 {
 	SDL_RWops *rw = SDL_RWFromConstMem(data, size);
-	_sound = Mix_LoadWAV_RW(rw, 1);
-	if (_sound == 0)
+	Mix_Chunk *sound = Mix_LoadWAV_RW(rw, 1);
+	if (sound == 0)
 	{
 		throw Exception(Mix_GetError());
 	}
+	unload();
+	_sound = sound;
+}
+
+/**
+ * Loads a sound that was already converted to the mixer's
+ * format from a cache file. The file is mapped into memory
+ * and played straight from there, without being copied.
+ * @param filename Filename of the cache file.
+ * @return True if the cache file matches the mixer and was loaded.
+ */
+bool Sound::loadCache(const std::string &filename)
+{
+	int frequency, channels;
+	Uint16 format;
+	if (!Mix_QuerySpec(&frequency, &format, &channels))
+	{
+		return false;
+	}
+	MappedFile *cache = new MappedFile();
+	const size_t headerSize = 4 + 4 * sizeof(Uint32);
+	if (!cache->open(filename) || cache->getSize() < headerSize)
+	{
+		delete cache;
+		return false;
+	}
+	Uint32 header[4];
+	memcpy(header, cache->getData() + 4, sizeof(header));
+	if (memcmp(cache->getData(), "OXSD", 4) != 0 ||
+		header[0] != (Uint32)frequency || header[1] != format || header[2] != (Uint32)channels ||
+		header[3] != cache->getSize() - headerSize)
+	{
+		delete cache;
+		return false;
+	}
+	// the mixer only reads the samples, effects work on a copy
+	Mix_Chunk *sound = Mix_QuickLoad_RAW((Uint8*)cache->getData() + headerSize, header[3]);
+	if (sound == 0)
+	{
+		delete cache;
+		return false;
+	}
+	unload();
+	_sound = sound;
+	_cache = cache;
+	return true;
+}
+
+/**
+ * Saves the sound as converted to the mixer's format,
+ * so it can be loaded as is next time.
+ * @param filename Filename of the cache file.
+ */
+void Sound::saveCache(const std::string &filename) const
+{
+	int frequency, channels;
+	Uint16 format;
+	if (_sound == 0 || _sound->alen == 0 || !Mix_QuerySpec(&frequency, &format, &channels))
+	{
+		return;
+	}
+	std::ofstream file(filename.c_str(), std::ios::binary);
+	if (!file)
+	{
+		Log(LOG_WARNING) << "Failed to save " << filename;
+		return;
+	}
+	Uint32 header[4] = { (Uint32)frequency, format, (Uint32)channels, _sound->alen };
+	file.write("OXSD", 4);
+	file.write((const char*)header, sizeof(header));
+	file.write((const char*)_sound->abuf, _sound->alen);
 }
 
 /**
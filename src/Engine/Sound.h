@@ -23,6 +23,8 @@
 namespace OpenXcom
 {
 
+class MappedFile;
+
 /**
  * Container for sound effects.
  * Handles loading and playing various formats through SDL_mixer.
@@ -31,6 +33,10 @@ class Sound
 {
 private:
 	Mix_Chunk *_sound;
+	MappedFile *_cache;
+
+	/// Frees the loaded sound.
+	void unload();
 public:
 	/// Creates a blank sound effect.
 	Sound();
@@ -40,6 +46,10 @@ public:
 	void load(const std::string &filename);
 	/// Loads sound from a chunk of memory.
 	void load(const void *data, unsigned int size);
+	/// Loads sound already converted for the mixer from a cache file.
+	bool loadCache(const std::string &filename);
+	/// Saves the sound converted for the mixer to a cache file.
+	void saveCache(const std::string &filename) const;
 	/// Plays the sound.
 	void play(int channel = -1, int angle = 0, int distance = 0) const;
 	/// Stops all sounds.
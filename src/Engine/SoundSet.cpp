@@ -20,8 +20,13 @@
 #include "CatFile.h"
 #include "Sound.h"
 #include "Exception.h"
+#include "CrossPlatform.h"
+#include "Options.h"
+#include "Logger.h"
 #include <sstream>
+#include <iomanip>
 #include <climits>
+#include <cstring>
 
 namespace OpenXcom
 {
@@ -52,7 +57,7 @@ SoundSet::~SoundSet()
  * @param newsound Pointer to converted sample buffer.
  * @return Converted buffer size.
  */
-int SoundSet::convertSampleRate(Uint8 *oldsound, unsigned int oldsize, Uint8 *newsound) const
+int SoundSet::convertSampleRate(const Uint8 *oldsound, unsigned int oldsize, Uint8 *newsound) const
 {
 	const Uint32 step16 = (8000 << 16) / 11025;
 	int newsize = 0;
@@ -67,7 +72,8 @@ int SoundSet::convertSampleRate(Uint8 *oldsound, unsigned int oldsize, Uint8 *ne
  * Loads the contents of an X-Com CAT file which usually contains
  * a set of sound files. The CAT starts with an index of the offset
  * and size of every file contained within. Each file consists of a
- * filename followed by its contents.
+ * filename followed by its contents. Only the index is read here,
+ * the sounds themselves are loaded the first time they're used.
  * @param filename Filename of the CAT set.
  * @param wav Are the sounds in WAV format?
  * @sa http://www.ufopaedia.org/index.php?title=SOUND
@@ -81,113 +87,217 @@ void SoundSet::loadCat(const std::string &filename, bool wav)
 		throw Exception(filename + " not found");
 	}
 
-	// Load each sound file
+	_files.push_back(filename);
 	for (int i = 0; i < sndFile.getAmount(); ++i)
 	{
-		// Read WAV chunk
-		unsigned char *sound = (unsigned char*) sndFile.load(i);
-		unsigned int size = sndFile.getObjectSize(i);
+		Sample sample;
+		sample.file = _files.size() - 1;
+		sample.index = i;
+		sample.format = wav ? SAMPLE_WAV : SAMPLE_DOS;
+		delete _sounds[i];
+		_sounds.erase(i);
+		_samples[i] = sample;
+	}
+}
+
+/**
+ * Gets the file the converted copy of a sound is cached in,
+ * named after its CAT file, when that was changed, and its index.
+ * @param sample The sound in its CAT file.
+ * @return Full path to the cache file.
+ */
+std::string SoundSet::getCacheFile(const Sample &sample) const
+{
+	std::ostringstream key;
+	key << _files[sample.file] << ":" << CrossPlatform::getDateModified(_files[sample.file]) << ":" << sample.format;
+	std::string str = key.str();
+	Uint64 hash = 14695981039346656037ULL;
+	for (std::string::const_iterator i = str.begin(); i != str.end(); ++i)
+	{
+		hash = (hash ^ (unsigned char)*i) * 1099511628211ULL;
+	}
+	std::ostringstream ss;
+	ss << Options::getUserFolder() << "sound/" << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << "-" << sample.index << ".raw";
+	return ss.str();
+}
+
+/**
+ * Loads a sound from its CAT file, adding a WAV header to raw
+ * samples and bringing 8 khz ones up to 11 khz. With the cache
+ * turned on, sounds are saved as converted for the mixer, and
+ * just mapped from there next time.
+ * @param sample The sound in its CAT file.
+ * @return Pointer to the new sound, empty if it's junk.
+ */
+Sound *SoundSet::loadSample(const Sample &sample) const
+{
+	Sound *s = new Sound();
+	std::string cache;
+	if (Options::cacheSounds)
+	{
+		cache = getCacheFile(sample);
+		if (s->loadCache(cache))
+		{
+			return s;
+		}
+	}
+
+	CatFile sndFile (_files[sample.file].c_str());
+	if (!sndFile || sample.index >= sndFile.getAmount())
+	{
+		Log(LOG_WARNING) << "Failed to load sound " << sample.index << " from " << _files[sample.file];
+		return s;
+	}
+
+	// Read WAV chunk straight from the mapped file
+	const unsigned char *sound = (const unsigned char*) sndFile.getObject(sample.index);
+	unsigned int size = sndFile.getObjectSize(sample.index);
 
-		// If there's no WAV header (44 bytes), add it
+	const int headerSize = 44;
+	char header[] = {'R', 'I', 'F', 'F', 0x00, 0x00, 0x00, 0x00, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ',
+					 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x11, 0x2b, 0x00, 0x00, 0x11, 0x2b, 0x00, 0x00, 0x01, 0x00, 0x08, 0x00,
+					 'd', 'a', 't', 'a', 0x00, 0x00, 0x00, 0x00};
+	unsigned char *newsound = 0;
+	switch (sample.format)
+	{
+	case SAMPLE_DOS:
+		// There's no WAV header (44 bytes), add it
 		// Assuming sounds are 6-bit 8000Hz (DOS version)
-		unsigned char *newsound = 0;
-		const int headerSize = 44;
-		if (!wav)
+		// skip 5 garbage name bytes at beginning and omit trailing null byte
+		size = (size > 6) ? size - 6 : 0;
+		if (size != 0)
 		{
-			if (size > 5) size -= 5; // skip 5 garbage name bytes at beginning
-			if (size) size--; // omit trailing null byte
-			if (size != 0)
-			{
-				char header[] = {'R', 'I', 'F', 'F', 0x00, 0x00, 0x00, 0x00, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ',
-								 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x11, 0x2b, 0x00, 0x00, 0x11, 0x2b, 0x00, 0x00, 0x01, 0x00, 0x08, 0x00,
-								 'd', 'a', 't', 'a', 0x00, 0x00, 0x00, 0x00};
+			// copy and do the conversion...
+			newsound = new unsigned char[headerSize + size*2];
+			memcpy(newsound, header, headerSize);
+			int newsize = convertSampleRate(sound + 5, size, newsound + headerSize);
+			size = newsize + headerSize;
 
-				// scale to 8 bits
-				for (unsigned int n = 0; n < size; ++n) sound[5 + n] *= 4;
+			// scale to 8 bits
+			for (int n = 0; n < newsize; ++n) newsound[headerSize + n] *= 4;
 
-				// copy and do the conversion...
-				newsound = new unsigned char[headerSize + size*2];
-				memcpy(newsound, header, headerSize);
-				memcpy(newsound + headerSize, sound + 5, size);
-				int newsize = convertSampleRate(sound + 5, size, newsound + headerSize);
-				size = newsize + headerSize;
+			// Rewrite the number of samples in the WAV file
+			int headersize = newsize + 36;
+			int soundsize = newsize;
+			memcpy(newsound + 4, &headersize, sizeof(headersize));
+			memcpy(newsound + 40, &soundsize, sizeof(soundsize));
+		}
+		break;
+	case SAMPLE_TFTD:
+		// there's no WAV header (44 bytes), add it
+		// sounds are 8-bit 11025Hz, signed
+		// skip 5 garbage name bytes at beginning and omit trailing null byte
+		size = (size > 6) ? size - 6 : 0;
+		if (size != 0)
+		{
+			int headersize = size + 36;
+			int soundsize = size;
+			memcpy(header + 4, &headersize, sizeof(headersize));
+			memcpy(header + 40, &soundsize, sizeof(soundsize));
+
+			newsound = new unsigned char[headerSize + size];
+			memcpy(newsound, header, headerSize);
 
-				// Rewrite the number of samples in the WAV file
-				int headersize = newsize + 36;
-				int soundsize = newsize;
-				memcpy(newsound + 4, &headersize, sizeof(headersize));
-				memcpy(newsound + 40, &soundsize, sizeof(soundsize));
+			// TFTD sounds are signed, so we need to convert them.
+			for (unsigned int n = 0; n < size; ++n)
+			{
+				int value = (int)sound[5 + n] + 128;
+				newsound[headerSize + n] = (uint8_t)value;
 			}
+			size = size + headerSize;
 		}
+		break;
+	case SAMPLE_WAV:
 		// so it's WAV, but in 8 khz, we have to convert it to 11 khz sound
-		else if (0x40 == sound[0x18] && 0x1F == sound[0x19] && 0x00 == sound[0x1A] && 0x00 == sound[0x1B])
+		if (size > headerSize && 0x40 == sound[0x18] && 0x1F == sound[0x19] && 0x00 == sound[0x1A] && 0x00 == sound[0x1B])
 		{
-			unsigned char *sound2 = new unsigned char[size*2];
+			newsound = new unsigned char[size*2];
 
-			// rewrite the samplerate in the header to 11 khz
-			sound[0x18]=0x11; sound[0x19]=0x2B; sound[0x1C]=0x11; sound[0x1D]=0x2B;
+			// copy and rewrite the samplerate in the header to 11 khz
+			memcpy(newsound, sound, headerSize);
+			newsound[0x18]=0x11; newsound[0x19]=0x2B; newsound[0x1C]=0x11; newsound[0x1D]=0x2B;
 
-			// copy and do the conversion...
-			memcpy(sound2, sound, size);
-			int newsize = convertSampleRate(sound + headerSize, size - headerSize, sound2 + headerSize);
+			// do the conversion...
+			int newsize = convertSampleRate(sound + headerSize, size - headerSize, newsound + headerSize);
 			size = newsize + headerSize;
 
 			// Rewrite the number of samples in the WAV file
-			memcpy(sound2 + 0x28, &newsize, sizeof(newsize));
-
-			// Ok, now replace the original with the converted:
-			delete[] sound;
-			sound = sound2;
+			memcpy(newsound + 0x28, &newsize, sizeof(newsize));
 		}
+		break;
+	}
 
-		Sound *s = new Sound();
-		try
-		{
-			if (size == 0)
-			{
-				throw Exception("Invalid sound file");
-			}
-			if (wav)
-				s->load(sound, size);
-			else
-				s->load(newsound, size);
-		}
-		catch (const Exception &)
+	try
+	{
+		if (size == 0)
 		{
-			// Ignore junk in the file
+			throw Exception("Invalid sound file");
 		}
-		_sounds[i] = s;
-
-		delete[] sound;
-		if (!wav)
+		s->load(newsound ? newsound : sound, size);
+		if (!cache.empty())
 		{
-			delete[] newsound;
+			std::string folder = Options::getUserFolder() + "sound/";
+			if (CrossPlatform::folderExists(folder) || CrossPlatform::createFolder(folder))
+			{
+				s->saveCache(cache);
+			}
 		}
 	}
+	catch (const Exception &)
+	{
+		// Ignore junk in the file
+	}
+
+	delete[] newsound;
+	return s;
+}
+
+/**
+ * Checks if there's a sound at a number in the set,
+ * without loading it.
+ * @param i Sound number in the set.
+ * @return True if there's a sound, loaded or not.
+ */
+bool SoundSet::hasSound(int i) const
+{
+	return _sounds.find(i) != _sounds.end() || _samples.find(i) != _samples.end();
 }
 
 /**
- * Returns a particular wave from the sound set.
+ * Returns a particular wave from the sound set,
+ * loading it from its CAT file if it's the first time.
  * @param i Sound number in the set.
  * @return Pointer to the respective sound.
  */
 Sound *SoundSet::getSound(unsigned int i)
 {
-	if (_sounds.find(i) != _sounds.end())
+	std::map<int, Sound*>::iterator sound = _sounds.find(i);
+	if (sound != _sounds.end())
 	{
-		return _sounds[i];
+		return sound->second;
+	}
+	std::map<int, Sample>::iterator sample = _samples.find(i);
+	if (sample != _samples.end())
+	{
+		Sound *s = loadSample(sample->second);
+		_samples.erase(sample);
+		_sounds[i] = s;
+		return s;
 	}
 	return 0;
 }
 
 
 /**
- * Creates and returns a particular wave in the sound set.
+ * Creates and returns a particular wave in the sound set,
+ * replacing any sound that was there.
  * @param i Sound number in the set.
  * @return Pointer to the respective sound.
  */
 Sound *SoundSet::addSound(unsigned int i)
 {
+	_samples.erase(i);
+	delete _sounds[i];
 	_sounds[i] = new Sound();
 	return _sounds[i];
 }
@@ -217,19 +327,20 @@ int SoundSet::getMaxSharedSounds() const
 
 /**
  * Returns the total amount of sounds currently
- * stored in the set.
+ * stored in the set, loaded or not.
  * @return Number of sounds.
  */
 size_t SoundSet::getTotalSounds() const
 {
-	return _sounds.size();
+	return _sounds.size() + _samples.size();
 }
 
 /**
  * Loads individual contents of a TFTD CAT file by index.
  * a set of sound files. The CAT starts with an index of the offset
  * and size of every file contained within. Each file consists of a
- * filename followed by its contents.
+ * filename followed by its contents. The sound itself is loaded
+ * the first time it's used.
  * @param filename Filename of the CAT set.
  * @param index which index in the cat file do we load?
  * @sa http://www.ufopaedia.org/index.php?title=SOUND
@@ -249,60 +360,15 @@ void SoundSet::loadCatbyIndex(const std::string &filename, int index)
 		throw Exception(err.str());
 	}
 
-	// Read WAV chunk
-	unsigned char *sound = (unsigned char*) sndFile.load(index);
-	unsigned int size = sndFile.getObjectSize(index);
-
-	// there's no WAV header (44 bytes), add it
-	// sounds are 8-bit 11025Hz, signed
-	unsigned char *newsound = 0;
-
-	if (size != 0)
-	{
-		char header[] = {'R', 'I', 'F', 'F', 0x00, 0x00, 0x00, 0x00, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ',
-							0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x11, 0x2b, 0x00, 0x00, 0x11, 0x2b, 0x00, 0x00, 0x01, 0x00, 0x08, 0x00,
-							'd', 'a', 't', 'a', 0x00, 0x00, 0x00, 0x00};
-
-
-		if (size > 5) size -= 5; // skip 5 garbage name bytes at beginning
-		if (size) size--; // omit trailing null byte
-
-		int headersize = size + 36;
-		int soundsize = size;
-		memcpy(header + 4, &headersize, sizeof(headersize));
-		memcpy(header + 40, &soundsize, sizeof(soundsize));
-
-		newsound = new unsigned char[44 + size];
-		memcpy(newsound, header, 44);
-
-		// TFTD sounds are signed, so we need to convert them.
-		for (unsigned int n = 5; n < size + 5; ++n)
-		{
-			int value = (int)sound[n] + 128;
-			sound[n] = (uint8_t)value;
-		}
-
-		if (size) memcpy(newsound + 44, sound+5, size);
-		size = size + 44;
-	}
-
-	Sound *s = new Sound();
-	try
+	if (_files.empty() || _files.back() != filename)
 	{
-		if (size == 0)
-		{
-			throw Exception("Invalid sound file");
-		}
-		s->load(newsound, size);
+		_files.push_back(filename);
 	}
-	catch (const Exception &)
-	{
-		// Ignore junk in the file
-	}
-	_sounds[getTotalSounds()] = s;
-
-	delete[] sound;
-	delete[] newsound;
+	Sample sample;
+	sample.file = _files.size() - 1;
+	sample.index = index;
+	sample.format = SAMPLE_TFTD;
+	_samples[getTotalSounds()] = sample;
 }
 
 }
@@ -20,6 +20,7 @@
 #include <SDL_mixer.h>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace OpenXcom
 {
@@ -29,15 +30,31 @@ class Sound;
 /**
  * Container of a set of sounds.
  * Used to manage file sets that contain a pack
- * of sounds inside.
+ * of sounds inside. Sounds in CAT files are only
+ * loaded the first time they're asked for.
  */
 class SoundSet
 {
 private:
+	/// Formats of the sounds in CAT files.
+	enum SampleFormat { SAMPLE_WAV, SAMPLE_DOS, SAMPLE_TFTD };
+	/// A sound in a CAT file that hasn't been loaded yet.
+	struct Sample
+	{
+		size_t file;
+		int index;
+		SampleFormat format;
+	};
 	std::map<int, Sound*> _sounds;
+	std::map<int, Sample> _samples;
+	std::vector<std::string> _files;
 	int _sharedSounds;
 
-	int convertSampleRate(Uint8 *oldsound, unsigned int oldsize, Uint8 *newsound) const;
+	int convertSampleRate(const Uint8 *oldsound, unsigned int oldsize, Uint8 *newsound) const;
+	/// Gets the cache file for a sound in a CAT file.
+	std::string getCacheFile(const Sample &sample) const;
+	/// Loads a sound from its CAT file.
+	Sound *loadSample(const Sample &sample) const;
 public:
 	/// Crates a sound set.
 	SoundSet();
@@ -45,6 +62,8 @@ public:
 	~SoundSet();
 	/// Loads an X-Com CAT set of sound files.
 	void loadCat(const std::string &filename, bool wav = true);
+	/// Checks if the set has a particular sound.
+	bool hasSound(int i) const;
 	/// Gets a particular sound from the set.
 	Sound *getSound(unsigned int i);
 	/// Creates a new sound and returns a pointer to it.
@@ -19,8 +19,12 @@
 #include "SurfaceSet.h"
 #include <fstream>
 #include <climits>
+#include <cstring>
+#include <algorithm>
 #include "Surface.h"
 #include "Exception.h"
+#include "FileMap.h"
+#include "MappedFile.h"
 
 namespace OpenXcom
 {
@@ -78,18 +82,14 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 	// Load TAB and get image offsets
 	if (!tab.empty())
 	{
-		std::ifstream offsetFile(tab.c_str(), std::ios::in | std::ios::binary);
+		const MappedFile *offsetFile = FileMap::mapFile(tab);
 		if (!offsetFile)
 		{
 			throw Exception(tab + " not found");
 		}
-		std::streampos begin, end;
-		begin = offsetFile.tellg();
-		int off;
-		offsetFile.read((char*)&off, sizeof(off));
-		offsetFile.seekg(0, std::ios::end);
-		end = offsetFile.tellg();
-		int size = end - begin;
+		int off = 0;
+		memcpy(&off, offsetFile->getData(), std::min(sizeof(off), offsetFile->getSize()));
+		int size = (int)offsetFile->getSize();
 		// 16-bit offsets
 		if (off != 0)
 		{
@@ -100,7 +100,6 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 		{
 			nframes = size / 4;
 		}
-		offsetFile.close();
 		for (int frame = 0; frame < nframes; ++frame)
 		{
 			_frames[frame] = new Surface(_width, _height);
@@ -113,12 +112,14 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 	}
 
 	// Load PCK and put pixels in surfaces
-	std::ifstream imgFile (pck.c_str(), std::ios::in | std::ios::binary);
+	const MappedFile *imgFile = FileMap::mapFile(pck);
 	if (!imgFile)
 	{
 		throw Exception(pck + " not found");
 	}
 
+	const Uint8 *data = imgFile->getData();
+	const Uint8 *end = data + imgFile->getSize();
 	Uint8 value;
 
 	for (int frame = 0; frame < nframes; ++frame)
@@ -128,7 +129,7 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 		// Lock the surface
 		_frames[frame]->lock();
 
-		imgFile.read((char*)&value, 1);
+		value = (data != end) ? *data++ : 0;
 		for (int i = 0; i < value; ++i)
 		{
 			for (int j = 0; j < _width; ++j)
@@ -137,11 +138,11 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 			}
 		}
 
-		while (imgFile.read((char*)&value, 1) && value != 255)
+		while (data != end && (value = *data++) != 255)
 		{
 			if (value == 254)
 			{
-				imgFile.read((char*)&value, 1);
+				value = (data != end) ? *data++ : 0;
 				for (int i = 0; i < value; ++i)
 				{
 					_frames[frame]->setPixelIterative(&x, &y, 0);
@@ -156,8 +157,6 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 		// Unlock the surface
 		_frames[frame]->unlock();
 	}
-
-	imgFile.close();
 }
 
 /**
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Timer.h"
+#include <algorithm>
 #include "Game.h"
 #include "Options.h"
 
@@ -41,6 +42,7 @@ Uint32 slowTick()
 
 Uint32 Timer::gameSlowSpeed = 1;
 int Timer::maxFrameSkip = 8; // this is a pretty good default at 60FPS.
+Uint32 Timer::_nextDue = 0xFFFFFFFF;
 
 
 /**
@@ -135,6 +137,14 @@ void Timer::think(State* state, Surface* surface)
 			if (_start > _frameSkipStart) _frameSkipStart = _start; // don't play animations in ffwd to catch up :P
 		}
 	}
+
+	if (_running)
+	{
+		// let the game loop know how long it can sleep for
+		Sint64 left = ((Sint64)_frameSkipStart + _interval - (Sint64)slowTick()) * gameSlowSpeed;
+		Uint32 due = SDL_GetTicks() + (Uint32)std::max(left, (Sint64)0);
+		_nextDue = std::min(_nextDue, due);
+	}
 }
 
 /**
@@ -164,4 +174,23 @@ void Timer::onTimer(SurfaceHandler handler)
 	_surface = handler;
 }
 
+/**
+ * Forgets when the timers are next due, so only the ones
+ * that think this time through the game loop count.
+ */
+void Timer::resetNextDue()
+{
+	_nextDue = 0xFFFFFFFF;
+}
+
+/**
+ * Returns when the earliest of the timers that thought
+ * since the last reset is next due.
+ * @return Time in SDL ticks, or 0xFFFFFFFF if none thought.
+ */
+Uint32 Timer::getNextDue()
+{
+	return _nextDue;
+}
+
 }
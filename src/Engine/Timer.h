@@ -39,6 +39,7 @@ public:
 	static Uint32 gameSlowSpeed;
 
 private:
+	static Uint32 _nextDue;
 	Uint32 _start;
 	Uint32 _frameSkipStart;
 	int _interval;
@@ -67,6 +68,10 @@ public:
 	void onTimer(StateHandler handler);
 	/// Hooks a surface action handler to the timer interval.
 	void onTimer(SurfaceHandler handler);
+	/// Forgets when the timers are due, before they think.
+	static void resetNextDue();
+	/// Gets when the next timer that thought is due.
+	static Uint32 getNextDue();
 };
 
 }
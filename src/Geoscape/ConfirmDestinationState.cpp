@@ -104,6 +104,7 @@ void ConfirmDestinationState::btnOkClick(Action *)
 	{
 		w->setId(_game->getSavedGame()->getId("STR_WAY_POINT"));
 		_game->getSavedGame()->getWaypoints()->push_back(w);
+		_game->getSavedGame()->getTargetGrid()->add(w);
 	}
 	_craft->setDestination(_target);
 	_craft->setStatus("STR_OUT");
@@ -302,6 +302,7 @@ void GeoscapeCraftState::btnCancelClick(Action *)
 	{
 		_waypoint->setId(_game->getSavedGame()->getId("STR_WAY_POINT"));
 		_game->getSavedGame()->getWaypoints()->push_back(_waypoint);
+		_game->getSavedGame()->getTargetGrid()->add(_waypoint);
 		_craft->setDestination(_waypoint);
 	}
 	// Cancel
@@ -42,6 +42,7 @@
 #include "../Savegame/Craft.h"
 #include "../Mod/RuleCraft.h"
 #include "../Savegame/Ufo.h"
+#include "../Savegame/TargetGrid.h"
 #include "../Mod/RuleUfo.h"
 #include "../Mod/RuleMissionScript.h"
 #include "../Savegame/Waypoint.h"
@@ -784,21 +785,15 @@ void GeoscapeState::time5Seconds()
 		{
 			if ((*j)->isDestroyed())
 			{
-				for (std::vector<Country*>::iterator country = _game->getSavedGame()->getCountries()->begin(); country != _game->getSavedGame()->getCountries()->end(); ++country)
+				Country *country = _game->getSavedGame()->locateCountry((*j)->getLongitude(), (*j)->getLatitude());
+				if (country)
 				{
-					if ((*country)->getRules()->insideCountry((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*country)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					country->addActivityXcom(-(*j)->getRules()->getScore());
 				}
-				for (std::vector<Region*>::iterator region = _game->getSavedGame()->getRegions()->begin(); region != _game->getSavedGame()->getRegions()->end(); ++region)
+				Region *region = _game->getSavedGame()->locateRegion((*j)->getLongitude(), (*j)->getLatitude());
+				if (region)
 				{
-					if ((*region)->getRules()->insideRegion((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*region)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					region->addActivityXcom(-(*j)->getRules()->getScore());
 				}
 				// if a transport craft has been shot down, kill all the soldiers on board.
 				if ((*j)->getRules()->getSoldiers() > 0)
@@ -1038,11 +1033,12 @@ class DetectXCOMBase: public std::unary_function<Ufo *, bool>
 {
 public:
 	/// Create a detector for the given base.
-	DetectXCOMBase(const Base &base) : _base(base) { /* Empty by design.  */ }
+	DetectXCOMBase(const Base &base, const std::vector<Target*> &nearby) : _base(base), _nearby(nearby) { /* Empty by design.  */ }
 	/// Attempt detection
 	bool operator()(const Ufo *ufo) const;
 private:
 	const Base &_base;	//!< The target base.
+	const std::vector<Target*> &_nearby;	//!< The targets close enough to the base.
 };
 
 /**
@@ -1052,6 +1048,7 @@ private:
  */
 bool DetectXCOMBase::operator()(const Ufo *ufo) const
 {
+	if (!std::binary_search(_nearby.begin(), _nearby.end(), ufo)) return false;
 	if (ufo->getTrajectoryPoint() <= 1) return false;
 	if (ufo->getTrajectory().getZone(ufo->getTrajectoryPoint()) == 5) return false;
 	if ((ufo->getMission()->getRules().getObjective() != OBJECTIVE_RETALIATION && !Options::aggressiveRetaliation) ||	// only UFOs on retaliation missions actively scan for bases
@@ -1080,6 +1077,8 @@ struct SetRetaliationTarget: public std::unary_function<std::map<const Region *,
  */
 void GeoscapeState::time10Minutes()
 {
+	TargetGrid *grid = _game->getSavedGame()->getTargetGrid();
+	std::vector<Target*> nearby;
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
 		// Fuel consumption for XCOM craft.
@@ -1098,9 +1097,10 @@ void GeoscapeState::time10Minutes()
 				if ((*j)->getDestination() == 0)
 				{
 					double range = Nautical((*j)->getRules()->getSightRange());
+					grid->getNear((*j)->getLongitude(), (*j)->getLatitude(), range, nearby);
 					for (std::vector<AlienBase*>::iterator b = _game->getSavedGame()->getAlienBases()->begin(); b != _game->getSavedGame()->getAlienBases()->end(); ++b)
 					{
-						if ((*j)->getDistance(*b) <= range)
+						if (std::binary_search(nearby.begin(), nearby.end(), *b) && (*j)->getDistance(*b) <= range)
 						{
 							if (RNG::percent(50-((*j)->getDistance(*b) / range) * 50) && !(*b)->isDiscovered())
 							{
@@ -1112,13 +1112,20 @@ void GeoscapeState::time10Minutes()
 			}
 		}
 	}
+	// Only UFOs within the longest sight range can detect a base
+	int sightRange = 0;
+	for (std::vector<Ufo*>::iterator u = _game->getSavedGame()->getUfos()->begin(); u != _game->getSavedGame()->getUfos()->end(); ++u)
+	{
+		sightRange = std::max(sightRange, (*u)->getRules()->getSightRange());
+	}
 	if (Options::aggressiveRetaliation)
 	{
 		// Detect as many bases as possible.
 		for (std::vector<Base*>::iterator iBase = _game->getSavedGame()->getBases()->begin(); iBase != _game->getSavedGame()->getBases()->end(); ++iBase)
 		{
 			// Find a UFO that detected this base, if any.
-			std::vector<Ufo*>::const_iterator uu = std::find_if (_game->getSavedGame()->getUfos()->begin(), _game->getSavedGame()->getUfos()->end(), DetectXCOMBase(**iBase));
+			grid->getNear((*iBase)->getLongitude(), (*iBase)->getLatitude(), Nautical(sightRange), nearby);
+			std::vector<Ufo*>::const_iterator uu = std::find_if (_game->getSavedGame()->getUfos()->begin(), _game->getSavedGame()->getUfos()->end(), DetectXCOMBase(**iBase, nearby));
 			if (uu != _game->getSavedGame()->getUfos()->end())
 			{
 				// Base found
@@ -1133,7 +1140,8 @@ void GeoscapeState::time10Minutes()
 		for (std::vector<Base*>::iterator iBase = _game->getSavedGame()->getBases()->begin(); iBase != _game->getSavedGame()->getBases()->end(); ++iBase)
 		{
 			// Find a UFO that detected this base, if any.
-			std::vector<Ufo*>::const_iterator uu = std::find_if (_game->getSavedGame()->getUfos()->begin(), _game->getSavedGame()->getUfos()->end(), DetectXCOMBase(**iBase));
+			grid->getNear((*iBase)->getLongitude(), (*iBase)->getLatitude(), Nautical(sightRange), nearby);
+			std::vector<Ufo*>::const_iterator uu = std::find_if (_game->getSavedGame()->getUfos()->begin(), _game->getSavedGame()->getUfos()->end(), DetectXCOMBase(**iBase, nearby));
 			if (uu != _game->getSavedGame()->getUfos()->end())
 			{
 				discovered[_game->getSavedGame()->locateRegion(**iBase)] = *iBase;
@@ -1187,13 +1195,10 @@ bool GeoscapeState::processMissionSite(MissionSite *site) const
 	{
 		region->addActivityAlien(score);
 	}
-	for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+	Country *country = _game->getSavedGame()->locateCountry(site->getLongitude(), site->getLatitude());
+	if (country)
 	{
-		if ((*k)->getRules()->insideCountry(site->getLongitude(), site->getLatitude()))
-		{
-			(*k)->addActivityAlien(score);
-			break;
-		}
+		country->addActivityAlien(score);
 	}
 	if (!removeSite)
 	{
@@ -1275,6 +1280,19 @@ void GeoscapeState::time30Minutes()
 		}
 	}
 
+	// Only bases and craft within the longest radar range can see a UFO
+	int radarRange = 0;
+	for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); b != _game->getSavedGame()->getBases()->end(); ++b)
+	{
+		radarRange = std::max(radarRange, (*b)->getMaxRadarRange());
+		for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); c != (*b)->getCrafts()->end(); ++c)
+		{
+			radarRange = std::max(radarRange, (*c)->getRules()->getRadarRange());
+		}
+	}
+	TargetGrid *grid = _game->getSavedGame()->getTargetGrid();
+	std::vector<Target*> nearby;
+
 	// Handle UFO detection and give aliens points
 	for (std::vector<Ufo*>::iterator u = _game->getSavedGame()->getUfos()->begin(); u != _game->getSavedGame()->getUfos()->end(); ++u)
 	{
@@ -1285,39 +1303,35 @@ void GeoscapeState::time30Minutes()
 			points *= 2;
 		case Ufo::FLYING:
 			// Get area
-			for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+			if (Region *region = _game->getSavedGame()->locateRegion(**u))
 			{
-				if ((*k)->getRules()->insideRegion((*u)->getLongitude(), (*u)->getLatitude()))
-				{
-					(*k)->addActivityAlien(points);
-					break;
-				}
+				region->addActivityAlien(points);
 			}
 			// Get country
-			for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+			if (Country *country = _game->getSavedGame()->locateCountry(**u))
 			{
-				if ((*k)->getRules()->insideCountry((*u)->getLongitude(), (*u)->getLatitude()))
-				{
-					(*k)->addActivityAlien(points);
-					break;
-				}
+				country->addActivityAlien(points);
 			}
+			grid->getNear((*u)->getLongitude(), (*u)->getLatitude(), Nautical(radarRange), nearby);
 			if (!(*u)->getDetected())
 			{
 				bool detected = false, hyperdetected = false;
 				for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); !hyperdetected && b != _game->getSavedGame()->getBases()->end(); ++b)
 				{
-					switch ((*b)->detect(*u))
+					if (std::binary_search(nearby.begin(), nearby.end(), *b))
 					{
-					case 2:	// hyper-wave decoder
-						(*u)->setHyperDetected(true);
-						hyperdetected = true;
-					case 1: // conventional radar
-						detected = true;
+						switch ((*b)->detect(*u))
+						{
+						case 2:	// hyper-wave decoder
+							(*u)->setHyperDetected(true);
+							hyperdetected = true;
+						case 1: // conventional radar
+							detected = true;
+						}
 					}
 					for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); !detected && c != (*b)->getCrafts()->end(); ++c)
 					{
-						if ((*c)->getStatus() == "STR_OUT" && (*c)->detect(*u))
+						if ((*c)->getStatus() == "STR_OUT" && std::binary_search(nearby.begin(), nearby.end(), *c) && (*c)->detect(*u))
 						{
 							detected = true;
 							break;
@@ -1335,20 +1349,23 @@ void GeoscapeState::time30Minutes()
 				bool detected = false, hyperdetected = false;
 				for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); !hyperdetected && b != _game->getSavedGame()->getBases()->end(); ++b)
 				{
-					switch ((*b)->insideRadarRange(*u))
+					if (std::binary_search(nearby.begin(), nearby.end(), *b))
 					{
-					case 2:	// hyper-wave decoder
-						detected = true;
-						hyperdetected = true;
-						(*u)->setHyperDetected(true);
-						break;
-					case 1: // conventional radar
-						detected = true;
-						hyperdetected = (*u)->getHyperDetected();
+						switch ((*b)->insideRadarRange(*u))
+						{
+						case 2:	// hyper-wave decoder
+							detected = true;
+							hyperdetected = true;
+							(*u)->setHyperDetected(true);
+							break;
+						case 1: // conventional radar
+							detected = true;
+							hyperdetected = (*u)->getHyperDetected();
+						}
 					}
 					for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); !detected && c != (*b)->getCrafts()->end(); ++c)
 					{
-						if ((*c)->getStatus() == "STR_OUT" && (*c)->insideRadarRange(*u))
+						if ((*c)->getStatus() == "STR_OUT" && std::binary_search(nearby.begin(), nearby.end(), *c) && (*c)->insideRadarRange(*u))
 						{
 							detected = true;
 							hyperdetected = (*u)->getHyperDetected();
@@ -1424,8 +1441,12 @@ void GeoscapeState::time1Hour()
 		for (std::vector<Transfer*>::iterator j = (*i)->getTransfers()->begin(); j != (*i)->getTransfers()->end(); ++j)
 		{
 			(*j)->advance(*i);
-			if (!window && (*j)->getHours() <= 0)
+			if ((*j)->getHours() <= 0)
 			{
+				if ((*j)->getCraft() != 0)
+				{
+					_game->getSavedGame()->getTargetGrid()->add((*j)->getCraft());
+				}
 				window = true;
 			}
 		}
@@ -1693,21 +1714,15 @@ void GeoscapeState::time1Day()
 	// handle regional and country points for alien bases
 	for (std::vector<AlienBase*>::const_iterator b = _game->getSavedGame()->getAlienBases()->begin(); b != _game->getSavedGame()->getAlienBases()->end(); ++b)
 	{
-		for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+		Region *region = _game->getSavedGame()->locateRegion((*b)->getLongitude(), (*b)->getLatitude());
+		if (region)
 		{
-			if ((*k)->getRules()->insideRegion((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien((*b)->getDeployment()->getPoints());
-				break;
-			}
+			region->addActivityAlien((*b)->getDeployment()->getPoints());
 		}
-		for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+		Country *country = _game->getSavedGame()->locateCountry((*b)->getLongitude(), (*b)->getLatitude());
+		if (country)
 		{
-			if ((*k)->getRules()->insideCountry((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien((*b)->getDeployment()->getPoints());
-				break;
-			}
+			country->addActivityAlien((*b)->getDeployment()->getPoints());
 		}
 	}
 
@@ -38,6 +38,7 @@
 #include "../Savegame/Region.h"
 #include "../Mod/City.h"
 #include "../Savegame/Target.h"
+#include "../Savegame/TargetGrid.h"
 #include "../Savegame/Ufo.h"
 #include "../Savegame/Craft.h"
 #include "../Savegame/Waypoint.h"
@@ -53,6 +54,8 @@
 #include "../Mod/RuleGlobe.h"
 #include "../Interface/Cursor.h"
 #include "../Engine/Screen.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/JobSystem.h"
 
 namespace OpenXcom
 {
@@ -244,6 +247,74 @@ struct CreateShadow
 	}
 };
 
+///fills the shade cache, same values as `CreateShadow` but without touching the globe pixels
+struct CacheShadow
+{
+	enum
+	{
+		///pixel not covered by the earth data, left as is
+		SHADOW_KEEP = 254,
+		///pixel outside of the earth, cleared
+		SHADOW_SPACE = 255,
+	};
+
+	static inline void func(Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise, const int&)
+	{
+		dest = earth.z ? CreateShadow::getShadowValue(earth, sun, noise) : (Uint8)SHADOW_SPACE;
+	}
+};
+
+///applies the shade cache to the globe pixels
+struct ApplyShadow
+{
+	static inline void func(Uint8& dest, const Uint8& shadow, const int&, const int&, const int&)
+	{
+		if (shadow == CacheShadow::SHADOW_KEEP)
+		{
+			return;
+		}
+		if (dest && shadow != CacheShadow::SHADOW_SPACE)
+		{
+			//this pixel is ocean
+			if (CreateShadow::isOcean(dest))
+			{
+				dest = CreateShadow::getOceanShadow(shadow);
+			}
+			//this pixel is land
+			else
+			{
+				dest = CreateShadow::getLandShadow(dest, shadow);
+			}
+		}
+		else
+		{
+			dest = 0;
+		}
+	}
+};
+
+///fills a band of rows of the shade cache, so the rows can be split over the worker threads
+class CacheShadowRows : public RangeJob
+{
+	std::vector<Uint8> &_cache;
+	ShaderMove<Cord> _earth;
+	ShaderRepeat<Sint16> _noise;
+	Cord _sun;
+	int _width, _height, _x, _y;
+public:
+	CacheShadowRows(std::vector<Uint8> &cache, const ShaderMove<Cord> &earth, const ShaderRepeat<Sint16> &noise, const Cord &sun, int width, int height, int x, int y) :
+		_cache(cache), _earth(earth), _noise(noise), _sun(sun), _width(width), _height(height), _x(x), _y(y)
+	{
+	}
+
+	void run(int begin, int end)
+	{
+		ShaderMove<Uint8> dest = ShaderMove<Uint8>(_cache, _width, _height, _x, _y);
+		dest.setDomain(GraphSubset(std::make_pair(0, _width), std::make_pair(begin, end)));
+		ShaderDraw<CacheShadow>(dest, _earth, ShaderScalar(_sun), _noise);
+	}
+};
+
 }//namespace
 
 
@@ -258,7 +329,7 @@ struct CreateShadow
  * @param y Y position in pixels.
  */
 Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _cenX(cenX), _cenY(cenY), _rotLon(0.0), _rotLat(0.0), _hoverLon(0.0), _hoverLat(0.0), _craftLon(0.0), _craftLat(0.0), _craftRange(0.0), _game(game), _hover(false), _craft(false), _blink(-1),
-																					_isMouseScrolling(false), _isMouseScrolled(false), _xBeforeMouseScrolling(0), _yBeforeMouseScrolling(0), _lonBeforeMouseScrolling(0.0), _latBeforeMouseScrolling(0.0), _mouseScrollingStartTime(0), _totalMouseMoveX(0), _totalMouseMoveY(0), _mouseMovedOverThreshold(false)
+																					_shadowZoom(0), _shadowCenX(0), _shadowCenY(0), _isMouseScrolling(false), _isMouseScrolled(false), _xBeforeMouseScrolling(0), _yBeforeMouseScrolling(0), _lonBeforeMouseScrolling(0.0), _latBeforeMouseScrolling(0.0), _mouseScrollingStartTime(0), _totalMouseMoveX(0), _totalMouseMoveY(0), _mouseMovedOverThreshold(false)
 {
 	_rules = game->getMod()->getGlobe();
 	_texture = new SurfaceSet(*_game->getMod()->getSurfaceSet("TEXTURE.DAT"));
@@ -289,6 +360,7 @@ Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y
 	for (size_t i=0; i<_randomNoiseData.size(); ++i)
 		_randomNoiseData[i] = rand()%4;
 
+	loadLand();
 	cachePolygons();
 }
 
@@ -305,11 +377,6 @@ Globe::~Globe()
 	delete _markerSet;
 	delete _radars;
 	delete _clipper;
-
-	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
-	{
-		delete *i;
-	}
 }
 
 /**
@@ -390,30 +457,32 @@ Polygon* Globe::getPolygonFromLonLat(double lon, double lat) const
 	double coslat = cos(lat);
 	double sinlat = sin(lat);
 
-	for (std::list<Polygon*>::iterator i = _rules->getPolygons()->begin(); i != _rules->getPolygons()->end(); ++i)
+	const std::vector<size_t> &candidates = _rules->getPolygonsAt(lon, lat);
+	for (std::vector<size_t>::const_iterator c = candidates.begin(); c != candidates.end(); ++c)
 	{
+		Polygon *poly = _rules->getIndexedPolygon(*c);
 		double x, y, z, x2, y2;
 		double clat, clon;
 		z = 0;
-		for (int j = 0; j < (*i)->getPoints(); ++j)
+		for (int j = 0; j < poly->getPoints(); ++j)
 		{
-			z = coslat * cos((*i)->getLatitude(j)) * cos((*i)->getLongitude(j) - lon) + sinlat * sin((*i)->getLatitude(j));
+			z = coslat * cos(poly->getLatitude(j)) * cos(poly->getLongitude(j) - lon) + sinlat * sin(poly->getLatitude(j));
 			if (z<zDiscard) break; //discarded
 		}
 		if (z<zDiscard) continue; //discarded
 
 		bool odd = false;
 
-		clat = (*i)->getLatitude(0); //initial point
-		clon = (*i)->getLongitude(0);
+		clat = poly->getLatitude(0); //initial point
+		clon = poly->getLongitude(0);
 		x = cos(clat) * sin(clon - lon);
 		y = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
 
-		for (int j = 0; j < (*i)->getPoints(); ++j)
+		for (int j = 0; j < poly->getPoints(); ++j)
 		{
-			int k = (j + 1) % (*i)->getPoints(); //index of next point in poly
-			clat = (*i)->getLatitude(k);
-			clon = (*i)->getLongitude(k);
+			int k = (j + 1) % poly->getPoints(); //index of next point in poly
+			clat = poly->getLatitude(k);
+			clon = poly->getLongitude(k);
 
 			x2 = cos(clat) * sin(clon - lon);
 			y2 = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
@@ -423,7 +492,7 @@ Polygon* Globe::getPolygonFromLonLat(double lon, double lat) const
 			y = y2;
 
 		}
-		if (odd) return *i;
+		if (odd) return poly;
 	}
 	return NULL;
 }
@@ -675,6 +744,32 @@ bool Globe::targetNear(Target* target, int x, int y) const
 	return (dx * dx + dy * dy <= NEAR_RADIUS);
 }
 
+/**
+ * Looks up the targets in the area of the globe under a
+ * cartesian point, so only those need to be checked with
+ * targetNear. Points close to the edge of the globe cover
+ * too much of it, so they just get every target.
+ * @param x X coordinate of point.
+ * @param y Y coordinate of point.
+ * @param targets List to fill with the targets, sorted by pointer.
+ */
+void Globe::getNearbyTargets(int x, int y, std::vector<Target*> &targets) const
+{
+	// allow for the rounding of the target's screen position
+	double reach = (sqrt((double)NEAR_RADIUS) + 2) / _radius;
+	double dx = x - _cenX, dy = y - _cenY;
+	double rho = sqrt(dx * dx + dy * dy) / _radius;
+	double lon = 0.0, lat = 0.0, radius = M_PI;
+	if (rho + reach < 1.0)
+	{
+		// the depth changes fastest towards the edge of the globe
+		double depth = sqrt(1.0 - rho * rho) - sqrt(1.0 - (rho + reach) * (rho + reach));
+		radius = 2 * asin(std::min(sqrt(reach * reach + depth * depth) / 2, 1.0));
+		cartToPolar(x, y, &lon, &lat);
+	}
+	_game->getSavedGame()->getTargetGrid()->getNear(lon, lat, radius, targets);
+}
+
 /**
  * Returns a list of all the targets currently near a certain
  * cartesian point over the globe.
@@ -685,7 +780,8 @@ bool Globe::targetNear(Target* target, int x, int y) const
  */
 std::vector<Target*> Globe::getTargets(int x, int y, bool craft) const
 {
-	std::vector<Target*> v;
+	std::vector<Target*> v, nearby;
+	getNearbyTargets(x, y, nearby);
 	if (!craft)
 	{
 		for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
@@ -693,7 +789,7 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft) const
 			if ((*i)->getLongitude() == 0.0 && (*i)->getLatitude() == 0.0)
 				continue;
 
-			if (targetNear((*i), x, y))
+			if (std::binary_search(nearby.begin(), nearby.end(), *i) && targetNear((*i), x, y))
 			{
 				v.push_back(*i);
 			}
@@ -703,7 +799,7 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft) const
 				if ((*j)->getLongitude() == (*i)->getLongitude() && (*j)->getLatitude() == (*i)->getLatitude() && (*j)->getDestination() == 0)
 					continue;
 
-				if (targetNear((*j), x, y))
+				if (std::binary_search(nearby.begin(), nearby.end(), *j) && targetNear((*j), x, y))
 				{
 					v.push_back(*j);
 				}
@@ -715,21 +811,21 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft) const
 		if (!(*i)->getDetected())
 			continue;
 
-		if (targetNear((*i), x, y))
+		if (std::binary_search(nearby.begin(), nearby.end(), *i) && targetNear((*i), x, y))
 		{
 			v.push_back(*i);
 		}
 	}
 	for (std::vector<Waypoint*>::iterator i = _game->getSavedGame()->getWaypoints()->begin(); i != _game->getSavedGame()->getWaypoints()->end(); ++i)
 	{
-		if (targetNear((*i), x, y))
+		if (std::binary_search(nearby.begin(), nearby.end(), *i) && targetNear((*i), x, y))
 		{
 			v.push_back(*i);
 		}
 	}
 	for (std::vector<MissionSite*>::iterator i = _game->getSavedGame()->getMissionSites()->begin(); i != _game->getSavedGame()->getMissionSites()->end(); ++i)
 	{
-		if (targetNear((*i), x, y))
+		if (std::binary_search(nearby.begin(), nearby.end(), *i) && targetNear((*i), x, y))
 		{
 			v.push_back(*i);
 		}
@@ -740,7 +836,7 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft) const
 		{
 			continue;
 		}
-		if (targetNear((*i), x, y))
+		if (std::binary_search(nearby.begin(), nearby.end(), *i) && targetNear((*i), x, y))
 		{
 			v.push_back(*i);
 		}
@@ -749,59 +845,137 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft) const
 }
 
 /**
- * Takes care of pre-calculating all the polygons currently visible
- * on the globe and caching them so they only need to be recalculated
- * when the globe is actually moved.
+ * Adds a point to the set.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
  */
-void Globe::cachePolygons()
-{
-	cache(_rules->getPolygons(), &_cacheLand);
+void Globe::GlobePoints::add(double lon, double lat)
+{
+	x.push_back(cos(lat) * cos(lon));
+	y.push_back(cos(lat) * sin(lon));
+	z.push_back(sin(lat));
+	screenX.push_back(0.0);
+	screenY.push_back(0.0);
+	pixelX.push_back(0);
+	pixelY.push_back(0);
+	depth.push_back(0.0);
 }
 
 /**
- * Caches a set of polygons.
- * @param polygons Pointer to list of polygons.
- * @param cache Pointer to cache.
+ * Removes all the points from the set.
  */
-void Globe::cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache)
-{
-	// Clear existing cache
-	for (std::list<Polygon*>::iterator i = cache->begin(); i != cache->end(); ++i)
+void Globe::GlobePoints::clear()
+{
+	x.clear();
+	y.clear();
+	z.clear();
+	screenX.clear();
+	screenY.clear();
+	pixelX.clear();
+	pixelY.clear();
+	depth.clear();
+}
+
+/**
+ * Converts the world polygons and polylines into flat arrays
+ * of points on the unit sphere, so they can be reprojected
+ * without any trigonometry or allocations every time the globe moves.
+ */
+void Globe::loadLand()
+{
+	std::list<Polygon*> *polygons = _rules->getPolygons();
+	_land.clear();
+	_landStart.clear();
+	_landTexture.clear();
+	_landVisible.clear();
+	_landStart.reserve(polygons->size() + 1);
+	_landTexture.reserve(polygons->size());
+	_landVisible.reserve(polygons->size());
+	for (std::list<Polygon*>::iterator i = polygons->begin(); i != polygons->end(); ++i)
+	{
+		_landStart.push_back(_land.size());
+		_landTexture.push_back((*i)->getTexture());
+		for (int j = 0; j < (*i)->getPoints(); ++j)
+		{
+			_land.add((*i)->getLongitude(j), (*i)->getLatitude(j));
+		}
+	}
+	_landStart.push_back(_land.size());
+
+	std::list<Polyline*> *polylines = _rules->getPolylines();
+	_detail.clear();
+	_detailStart.clear();
+	_detailStart.reserve(polylines->size() + 1);
+	for (std::list<Polyline*>::iterator i = polylines->begin(); i != polylines->end(); ++i)
 	{
-		delete *i;
+		_detailStart.push_back(_detail.size());
+		for (int j = 0; j < (*i)->getPoints(); ++j)
+		{
+			_detail.add((*i)->getLongitude(j), (*i)->getLatitude(j));
+		}
 	}
-	cache->clear();
+	_detailStart.push_back(_detail.size());
+}
 
-	// Pre-calculate values to cache
-	for (std::list<Polygon*>::iterator i = polygons->begin(); i != polygons->end(); ++i)
+/**
+ * Projects a whole set of points onto the globe at once,
+ * same as polarToCart() and pointBack() would for each one.
+ * @param points Set of points to update.
+ */
+void Globe::projectPoints(GlobePoints &points) const
+{
+	const size_t n = points.size();
+	if (n == 0)
+		return;
+	const double cosLat = cos(_cenLat), sinLat = sin(_cenLat);
+	const double cosLon = cos(_cenLon), sinLon = sin(_cenLon);
+	const double radius = _radius;
+	const double *px = &points.x[0], *py = &points.y[0], *pz = &points.z[0];
+	double *sx = &points.screenX[0], *sy = &points.screenY[0], *depth = &points.depth[0];
+	Sint16 *ix = &points.pixelX[0], *iy = &points.pixelY[0];
+
+	// Orthographic projection
+	for (size_t i = 0; i < n; ++i)
+	{
+		double across = py[i] * cosLon - px[i] * sinLon; // cos(lat) * sin(lon - cenLon)
+		double along = px[i] * cosLon + py[i] * sinLon; // cos(lat) * cos(lon - cenLon)
+		double dx = radius * across;
+		double dy = radius * (cosLat * pz[i] - sinLat * along);
+		sx[i] = _cenX + dx;
+		sy[i] = _cenY + dy;
+		ix[i] = _cenX + (Sint16)floor(dx);
+		iy[i] = _cenY + (Sint16)floor(dy);
+		depth[i] = cosLat * along + sinLat * pz[i];
+	}
+}
+
+/**
+ * Projects the land polygons and polylines onto the globe
+ * and picks the polygons facing the viewer. The points are
+ * reprojected in place so they only need to be recalculated
+ * when the globe is actually moved.
+ */
+void Globe::cachePolygons()
+{
+	projectPoints(_land);
+	projectPoints(_detail);
+
+	_landVisible.clear();
+	for (size_t i = 0; i + 1 < _landStart.size(); ++i)
 	{
 		// Is quad on the back face?
 		double closest = 0.0;
-		double z;
 		double furthest = 0.0;
-		for (int j = 0; j < (*i)->getPoints(); ++j)
+		for (size_t j = _landStart[i]; j < _landStart[i + 1]; ++j)
 		{
-			z = cos(_cenLat) * cos((*i)->getLatitude(j)) * cos((*i)->getLongitude(j) - _cenLon) + sin(_cenLat) * sin((*i)->getLatitude(j));
-			if (z > closest)
-				closest = z;
-			else if (z < furthest)
-				furthest = z;
+			if (_land.depth[j] > closest)
+				closest = _land.depth[j];
+			else if (_land.depth[j] < furthest)
+				furthest = _land.depth[j];
 		}
 		if (-furthest > closest)
 			continue;
-
-		Polygon* p = new Polygon(**i);
-
-		// Convert coordinates
-		for (int j = 0; j < p->getPoints(); ++j)
-		{
-			Sint16 x, y;
-			polarToCart(p->getLongitude(j), p->getLatitude(j), &x, &y);
-			p->setX(j, x);
-			p->setY(j, y);
-		}
-
-		cache->push_back(p);
+		_landVisible.push_back(i);
 	}
 }
 
@@ -867,6 +1041,7 @@ void Globe::rotate()
  */
 void Globe::draw()
 {
+	ProfileTimer timer(PROFILE_GLOBE);
 	if (_redraw)
 	{
 		cachePolygons();
@@ -902,19 +1077,13 @@ void Globe::drawOcean()
  */
 void Globe::drawLand()
 {
-	Sint16 x[4], y[4];
-
-	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
+	for (std::vector<size_t>::const_iterator i = _landVisible.begin(); i != _landVisible.end(); ++i)
 	{
-		// Convert coordinates
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			x[j] = (*i)->getX(j);
-			y[j] = (*i)->getY(j);
-		}
+		size_t start = _landStart[*i];
+		int points = _landStart[*i + 1] - start;
 
 		// Apply textures according to zoom and shade
-		drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + _zoomTexture), 0, 0);
+		drawTexturedPolygon(&_land.pixelX[start], &_land.pixelY[start], points, _texture->getFrame(_landTexture[*i] + _zoomTexture), 0, 0);
 	}
 }
 
@@ -976,13 +1145,34 @@ Cord Globe::getSunDirection(double lon, double lat) const
 
 void Globe::drawShadow()
 {
-	ShaderMove<Cord> earth = ShaderMove<Cord>(_earthData[_zoom], getWidth(), getHeight());
-	ShaderRepeat<Sint16> noise = ShaderRepeat<Sint16>(_randomNoiseData, static_data.random_surf_size, static_data.random_surf_size);
+	// small changes of the sun direction don't change the shading,
+	// so round it off to keep using the same shades for a while
+	const double SUN_STEP = 1024.0;
+	Cord sun = getSunDirection(_cenLon, _cenLat);
+	sun.x = Round(sun.x * SUN_STEP) / SUN_STEP;
+	sun.y = Round(sun.y * SUN_STEP) / SUN_STEP;
+	sun.z = Round(sun.z * SUN_STEP) / SUN_STEP;
 
-	earth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
+	const size_t size = getWidth() * getHeight();
+	if (_shadowCache.size() != size || _shadowZoom != _zoom || _shadowCenX != _cenX || _shadowCenY != _cenY ||
+		_shadowSun.x != sun.x || _shadowSun.y != sun.y || _shadowSun.z != sun.z)
+	{
+		ShaderMove<Cord> earth = ShaderMove<Cord>(_earthData[_zoom], getWidth(), getHeight());
+		ShaderRepeat<Sint16> noise = ShaderRepeat<Sint16>(_randomNoiseData, static_data.random_surf_size, static_data.random_surf_size);
+
+		earth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
+
+		_shadowCache.assign(size, (Uint8)CacheShadow::SHADOW_KEEP);
+		CacheShadowRows rows(_shadowCache, earth, noise, sun, getWidth(), getHeight(), getX(), getY());
+		JobSystem::parallelFor(&rows, 0, getHeight(), 16);
+		_shadowSun = sun;
+		_shadowZoom = _zoom;
+		_shadowCenX = _cenX;
+		_shadowCenY = _cenY;
+	}
 
 	lock();
-	ShaderDraw<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise);
+	ShaderDraw<ApplyShadow>(ShaderSurface(this), ShaderMove<Uint8>(_shadowCache, getWidth(), getHeight(), getX(), getY()));
 	unlock();
 
 }
@@ -1057,6 +1247,11 @@ void Globe::drawRadars()
 {
 	_radars->clear();
 
+	for (std::list<RadarCircle>::iterator i = _radarCircles.begin(); i != _radarCircles.end(); ++i)
+	{
+		i->used = false;
+	}
+
 	// Draw craft circle instead of radar circles to avoid confusion
 	if (_craft)
 	{
@@ -1069,11 +1264,15 @@ void Globe::drawRadars()
 		}
 
 		_radars->unlock();
+		clearRadarCircles();
 		return;
 	}
 
 	if (!Options::globeRadarLines)
+	{
+		clearRadarCircles();
 		return;
+	}
 
 	double tr, range;
 	double lat, lon;
@@ -1136,6 +1335,26 @@ void Globe::drawRadars()
 	}
 
 	_radars->unlock();
+	clearRadarCircles();
+}
+
+/**
+ * Forgets the cached radar circles that weren't drawn
+ * in the last radar pass.
+ */
+void Globe::clearRadarCircles()
+{
+	for (std::list<RadarCircle>::iterator i = _radarCircles.begin(); i != _radarCircles.end();)
+	{
+		if (!i->used)
+		{
+			i = _radarCircles.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
 }
 
 /**
@@ -1143,26 +1362,42 @@ void Globe::drawRadars()
  */
 void Globe::drawGlobeCircle(double lat, double lon, double radius, int segments, int frac)
 {
-	double x, y, x2 = 0, y2 = 0;
-	double lat1, lon1;
-	double seg = M_PI / (static_cast<double>(segments) / 2);
-	int i = 0;
-	for (double az = 0; az <= M_PI*2+0.01; az+=seg) //48 circle segments
-	{
-		//calculating sphere-projected circle
-		lat1 = asin(sin(lat) * cos(radius) + cos(lat) * sin(radius) * cos(az));
-		lon1 = lon + atan2(sin(az) * sin(radius) * cos(lat), cos(radius) - sin(lat) * sin(lat1));
-		polarToCart(lon1, lat1, &x, &y);
-		if ( AreSame(az, 0.0) ) //first vertex is for initialization only
+	// the circle only changes when its center or range does, so keep its points around
+	RadarCircle *circle = 0;
+	for (std::list<RadarCircle>::iterator i = _radarCircles.begin(); i != _radarCircles.end(); ++i)
+	{
+		if (i->lat == lat && i->lon == lon && i->radius == radius && i->segments == segments)
 		{
-			x2=x;
-			y2=y;
-			continue;
+			circle = &*i;
+			break;
+		}
+	}
+	if (circle == 0)
+	{
+		_radarCircles.push_back(RadarCircle());
+		circle = &_radarCircles.back();
+		circle->lat = lat;
+		circle->lon = lon;
+		circle->radius = radius;
+		circle->segments = segments;
+		double seg = M_PI / (static_cast<double>(segments) / 2);
+		for (double az = 0; az <= M_PI*2+0.01; az+=seg) //48 circle segments
+		{
+			//calculating sphere-projected circle
+			double lat1 = asin(sin(lat) * cos(radius) + cos(lat) * sin(radius) * cos(az));
+			double lon1 = lon + atan2(sin(az) * sin(radius) * cos(lat), cos(radius) - sin(lat) * sin(lat1));
+			circle->points.add(lon1, lat1);
 		}
-		if (!pointBack(lon1,lat1) && i % frac == 0)
-			XuLine(_radars, this, x, y, x2, y2, 6);
-		x2=x; y2=y;
-		i++;
+	}
+	circle->used = true;
+
+	GlobePoints &points = circle->points;
+	projectPoints(points);
+	//first vertex is for initialization only
+	for (size_t i = 1; i < points.size(); ++i)
+	{
+		if (points.depth[i] >= 0.0 && (i - 1) % frac == 0)
+			XuLine(_radars, this, points.screenX[i], points.screenY[i], points.screenX[i - 1], points.screenY[i - 1], 6);
 	}
 }
 
@@ -1235,20 +1470,16 @@ void Globe::drawDetail()
 		// Lock the surface
 		_countries->lock();
 
-		for (std::list<Polyline*>::iterator i = _rules->getPolylines()->begin(); i != _rules->getPolylines()->end(); ++i)
+		// Points were already projected along with the land
+		for (size_t i = 0; i + 1 < _detailStart.size(); ++i)
 		{
-			Sint16 x[2], y[2];
-			for (int j = 0; j < (*i)->getPoints() - 1; ++j)
+			for (size_t j = _detailStart[i]; j + 1 < _detailStart[i + 1]; ++j)
 			{
 				// Don't draw if polyline is facing back
-				if (pointBack((*i)->getLongitude(j), (*i)->getLatitude(j)) || pointBack((*i)->getLongitude(j + 1), (*i)->getLatitude(j + 1)))
+				if (_detail.depth[j] < 0.0 || _detail.depth[j + 1] < 0.0)
 					continue;
 
-				// Convert coordinates
-				polarToCart((*i)->getLongitude(j), (*i)->getLatitude(j), &x[0], &y[0]);
-				polarToCart((*i)->getLongitude(j + 1), (*i)->getLatitude(j + 1), &x[1], &y[1]);
-
-				_countries->drawLine(x[0], y[0], x[1], y[1], LINE_COLOR);
+				_countries->drawLine(_detail.pixelX[j], _detail.pixelY[j], _detail.pixelX[j + 1], _detail.pixelY[j + 1], LINE_COLOR);
 			}
 		}
 
@@ -1877,6 +2108,7 @@ void Globe::setupRadii(int width, int height)
 	_radiusStep = (_zoomRadius[DOGFIGHT_ZOOM] - _zoomRadius[0]) / 10.0;
 
 	_earthData.resize(_zoomRadius.size());
+	_shadowCache.clear();
 	//filling normal field for each radius
 
 	for (size_t r = 0; r<_zoomRadius.size(); ++r)
@@ -62,13 +62,59 @@ private:
 	bool _hover, _craft;
 	int _blink;
 	Timer *_blinkTimer, *_rotTimer;
-	std::list<Polygon*> _cacheLand;
+	/**
+	 * Set of points on the globe, stored as unit sphere coordinates
+	 * so they can be reprojected in place without any trigonometry.
+	 */
+	struct GlobePoints
+	{
+		std::vector<double> x, y, z;
+		///projected screen position, exact and rounded down to pixels
+		std::vector<double> screenX, screenY;
+		std::vector<Sint16> pixelX, pixelY;
+		///distance towards the viewer, negative if on the back of the globe
+		std::vector<double> depth;
+
+		/// Adds a point in polar coordinates.
+		void add(double lon, double lat);
+		/// Removes all the points.
+		void clear();
+		/// Gets the number of points.
+		size_t size() const { return x.size(); }
+	};
+	/// Cached geometry of a radar range circle.
+	struct RadarCircle
+	{
+		double lat, lon, radius;
+		int segments;
+		bool used;
+		GlobePoints points;
+	};
+
+	///every land polygon point, reprojected in place
+	GlobePoints _land;
+	///first point and texture of each land polygon
+	std::vector<size_t> _landStart;
+	std::vector<int> _landTexture;
+	///land polygons currently facing the viewer
+	std::vector<size_t> _landVisible;
+	///every country border point and the first point of each polyline
+	GlobePoints _detail;
+	std::vector<size_t> _detailStart;
+	///radar circles drawn recently, kept until their base or craft moves or changes range
+	std::list<RadarCircle> _radarCircles;
 	FastLineClip *_clipper;
 	double _radius, _radiusStep;
 	///normal of each pixel in earth globe per zoom level
 	std::vector<std::vector<Cord> > _earthData;
 	///data sample used for noise in shading
 	std::vector<Sint16> _randomNoiseData;
+	///shade of each pixel in earth globe, reused while the view and sun don't change
+	std::vector<Uint8> _shadowCache;
+	///sun direction, zoom and center the shade cache was made for
+	Cord _shadowSun;
+	size_t _shadowZoom;
+	Sint16 _shadowCenX, _shadowCenY;
 	///list of dimension of earth on screen per zoom level
 	std::vector<double> _zoomRadius;
 
@@ -87,12 +133,18 @@ private:
 	Polygon* getPolygonFromLonLat(double lon, double lat) const;
 	/// Checks if a target is near a point.
 	bool targetNear(Target* target, int x, int y) const;
-	/// Caches a set of polygons.
-	void cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache);
+	/// Gets the targets that might be near a point.
+	void getNearbyTargets(int x, int y, std::vector<Target*> &targets) const;
+	/// Loads the land polygons and polylines into the projection buffers.
+	void loadLand();
+	/// Projects a set of points onto the globe.
+	void projectPoints(GlobePoints &points) const;
 	/// Get position of sun relative to given position in polar cords and date.
 	Cord getSunDirection(double lon, double lat) const;
 	/// Draw globe range circle.
 	void drawGlobeCircle(double lat, double lon, double radius, int segments, int frac = 1);
+	/// Forget radar circles that aren't drawn anymore.
+	void clearRadarCircles();
 	/// Special "transparent" line.
 	void XuLine(Surface* surface, Surface* src, double x1, double y1, double x2, double y2, int shade);
 	/// Draw line on globe surface.
@@ -19,9 +19,12 @@
 
 #include "FpsCounter.h"
 #include <cmath>
+#include <climits>
 #include "../Engine/Action.h"
 #include "../Engine/Timer.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/JobSystem.h"
 #include "NumberText.h"
 
 namespace OpenXcom
@@ -43,6 +46,13 @@ FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, hei
 	_timer->start();
 
 	_text = new NumberText(width, height, x, y);
+
+	_graph = new Surface(Profiler::FRAMES + 30, PROFILE_SECTIONS * 6 + 6, x, y + height + 1);
+	for (int i = 0; i < PROFILE_SECTIONS; ++i)
+	{
+		_times[i] = new NumberText(24, 5, Profiler::FRAMES + 6, i * 6);
+		_colors[i] = 0;
+	}
 }
 
 /**
@@ -52,6 +62,11 @@ FpsCounter::~FpsCounter()
 {
 	delete _text;
 	delete _timer;
+	delete _graph;
+	for (int i = 0; i < PROFILE_SECTIONS; ++i)
+	{
+		delete _times[i];
+	}
 }
 
 /**
@@ -64,6 +79,33 @@ void FpsCounter::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
 	_text->setPalette(colors, firstcolor, ncolors);
+	_graph->setPalette(colors, firstcolor, ncolors);
+	for (int i = 0; i < PROFILE_SECTIONS; ++i)
+	{
+		_times[i]->setPalette(colors, firstcolor, ncolors);
+	}
+
+	// Pick the closest colors in the palette for the graph
+	static const int rgb[PROFILE_SECTIONS][3] =
+	{
+		{ 128, 128, 128 }, { 0, 200, 0 }, { 60, 100, 255 }, { 255, 220, 0 }, { 255, 140, 0 }, { 0, 200, 200 },
+		{ 180, 80, 220 }, { 240, 240, 240 }, { 255, 255, 140 }, { 230, 40, 40 }, { 255, 120, 180 }, { 160, 90, 40 }
+	};
+	SDL_Color *palette = getPalette();
+	for (int i = 0; i < PROFILE_SECTIONS; ++i)
+	{
+		int best = INT_MAX;
+		for (int c = 1; c < 256; ++c)
+		{
+			int r = palette[c].r - rgb[i][0], g = palette[c].g - rgb[i][1], b = palette[c].b - rgb[i][2];
+			int distance = r * r + g * g + b * b;
+			if (distance < best)
+			{
+				best = distance;
+				_colors[i] = c;
+			}
+		}
+	}
 }
 
 /**
@@ -73,17 +115,30 @@ void FpsCounter::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 void FpsCounter::setColor(Uint8 color)
 {
 	_text->setColor(color);
+	for (int i = 0; i < PROFILE_SECTIONS; ++i)
+	{
+		_times[i]->setColor(color);
+	}
 }
 
 /**
- * Shows / hides the FPS counter.
+ * Shows / hides the FPS counter,
+ * or the profiler graph with Ctrl.
  * @param action Pointer to an action.
  */
 void FpsCounter::handle(Action *action)
 {
 	if (action->getDetails()->type == SDL_KEYDOWN && action->getDetails()->key.keysym.sym == Options::keyFps)
 	{
-		_visible = !_visible;
+		if ((SDL_GetModState() & KMOD_CTRL) != 0)
+		{
+			Options::profiler = !Options::profiler;
+			_visible = _visible || Options::profiler;
+		}
+		else
+		{
+			_visible = !_visible;
+		}
 		Options::fpsCounter = _visible;
 	}
 }
@@ -97,13 +152,15 @@ void FpsCounter::think()
 }
 
 /**
- * Updates the amount of Frames per Second.
+ * Updates the amount of Frames per Second
+ * and how busy the worker threads were.
  */
 void FpsCounter::update()
 {
 	int fps = (int)floor((double)_frames / _timer->getTime() * 1000);
 	_text->setValue(fps);
 	_frames = 0;
+	JobSystem::getUtilization(_usage);
 	_redraw = true;
 }
 
@@ -116,6 +173,82 @@ void FpsCounter::draw()
 	_text->blit(this);
 }
 
+/**
+ * Draws the time each step of the main loop took in the last frames
+ * as stacked bars, two pixels per millisecond, with a line at the frame
+ * rate the game is aiming for. Next to it is the average time
+ * spent in every section, in microseconds. Below it is a bar
+ * per worker thread filled up to how busy it was last second.
+ */
+void FpsCounter::drawGraph()
+{
+	_graph->clear();
+	int height = _graph->getHeight() - 6;
+	_graph->lock();
+	for (int i = 0; i < Profiler::FRAMES; ++i)
+	{
+		int y = height;
+		for (int j = 0; j < PROFILE_SECTIONS; ++j)
+		{
+			ProfileSection section = (ProfileSection)j;
+			if (!Profiler::isTopLevel(section))
+			{
+				continue;
+			}
+			int pixels = (int)(Profiler::getFrameTime(i, section) * 2.0f + 0.5f);
+			for (; pixels > 0 && y > 0; --pixels)
+			{
+				--y;
+				_graph->setPixel(i, y, _colors[j]);
+			}
+		}
+	}
+	if (Options::FPS > 0)
+	{
+		int y = height - 2000 / Options::FPS;
+		for (int i = 0; i < Profiler::FRAMES && y >= 0; i += 4)
+		{
+			_graph->setPixel(i, y, _text->getColor());
+		}
+	}
+	_graph->unlock();
+	for (int i = 0; i < PROFILE_SECTIONS; ++i)
+	{
+		_graph->drawRect(Profiler::FRAMES + 2, i * 6, 3, 5, _colors[i]);
+		_times[i]->setValue((unsigned int)(Profiler::getAverageTime((ProfileSection)i) * 1000.0f));
+		_times[i]->blit(_graph);
+	}
+	for (size_t i = 0; i < _usage.size(); ++i)
+	{
+		int x = (int)i * 6;
+		if (x + 5 > Profiler::FRAMES)
+		{
+			break;
+		}
+		int pixels = (int)(_usage[i] * 5.0f + 0.5f);
+		_graph->drawRect(x, height + 1, 5, 5, _colors[0]);
+		if (pixels > 0)
+		{
+			_graph->drawRect(x, height + 6 - pixels, 5, pixels, _colors[1]);
+		}
+	}
+}
+
+/**
+ * Blits the FPS counter onto another surface,
+ * along with the profiler graph if it's on.
+ * @param surface Pointer to surface to blit onto.
+ */
+void FpsCounter::blit(Surface *surface)
+{
+	Surface::blit(surface);
+	if (_visible && Options::profiler)
+	{
+		drawGraph();
+		_graph->blit(surface);
+	}
+}
+
 void FpsCounter::addFrame()
 {
 	_frames++;
@@ -17,7 +17,9 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <vector>
 #include "../Engine/Surface.h"
+#include "../Engine/Profiler.h"
 
 namespace OpenXcom
 {
@@ -29,6 +31,9 @@ class Action;
 /**
  * Counts the amount of frames each second
  * and displays them in a NumberText surface.
+ * With the profiler on, it also shows a graph of where
+ * the time went in the last frames and how busy
+ * the worker threads were.
  */
 class FpsCounter : public Surface
 {
@@ -36,6 +41,13 @@ private:
 	NumberText *_text;
 	Timer *_timer;
 	int _frames;
+	Surface *_graph;
+	NumberText *_times[PROFILE_SECTIONS];
+	Uint8 _colors[PROFILE_SECTIONS];
+	std::vector<float> _usage;
+
+	/// Draws the profiler graph.
+	void drawGraph();
 public:
 	/// Creates a new FPS counter linked to a game.
 	FpsCounter(int width, int height, int x, int y);
@@ -53,6 +65,8 @@ public:
 	void update();
 	/// Draws the FPS counter.
 	void draw();
+	/// Blits the FPS counter and profiler graph.
+	void blit(Surface *surface);
 	void addFrame();
 };
 
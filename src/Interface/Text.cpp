@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Text.h"
+#include <algorithm>
 #include "../fmath.h"
 #include "../Engine/Font.h"
 #include "../Engine/Options.h"
@@ -551,37 +552,56 @@ void Text::draw()
 	// Invert text by inverting the font palette on index 3 (font palettes use indices 1-5)
 	int mid = _invert ? 3 : 0;
 
-	// Draw each letter one by one
-	for (UString::const_iterator c = s.begin(); c != s.end(); ++c)
+	// Draw the letters in runs on the same line with the same color,
+	// which the font keeps around already put together
+	UString run;
+	int runWidth = 0;
+	for (UString::const_iterator c = s.begin(); ; ++c)
 	{
-		if (Unicode::isSpace(*c) || *c == '\t')
+		if (c == s.end() || Unicode::isLinebreak(*c) || *c == Unicode::TOK_COLOR_FLIP)
 		{
-			x += dir * font->getCharSize(*c).w;
-		}
-		else if (Unicode::isLinebreak(*c))
-		{
-			line++;
-			y += font->getCharSize(*c).h;
-			x = getLineX(line);
-			if (*c == Unicode::TOK_NL_SMALL)
+			if (!run.empty())
 			{
-				font = _small;
+				if (dir < 0)
+				{
+					std::reverse(run.begin(), run.end());
+					x -= runWidth;
+				}
+				Surface* chr = font->getRun(run);
+				if (chr != 0)
+				{
+					ShaderDraw<PaletteShift>(ShaderSurface(this, 0, 0), ShaderSurface(chr, x, y), ShaderScalar(color), ShaderScalar(mul), ShaderScalar(mid));
+				}
+				if (dir > 0)
+				{
+					x += runWidth;
+				}
+				run.clear();
+				runWidth = 0;
+			}
+			if (c == s.end())
+			{
+				break;
+			}
+			else if (*c == Unicode::TOK_COLOR_FLIP)
+			{
+				color = (color == _color ? _color2 : _color);
+			}
+			else
+			{
+				line++;
+				y += font->getCharSize(*c).h;
+				x = getLineX(line);
+				if (*c == Unicode::TOK_NL_SMALL)
+				{
+					font = _small;
+				}
 			}
-		}
-		else if (*c == Unicode::TOK_COLOR_FLIP)
-		{
-			color = (color == _color ? _color2 : _color);
 		}
 		else
 		{
-			if (dir < 0)
-				x += dir * font->getCharSize(*c).w;
-			Surface* chr = font->getChar(*c);
-			chr->setX(x);
-			chr->setY(y);
-			ShaderDraw<PaletteShift>(ShaderSurface(this, 0, 0), ShaderCrop(chr), ShaderScalar(color), ShaderScalar(mul), ShaderScalar(mid));
-			if (dir > 0)
-				x += dir * font->getCharSize(*c).w;
+			run += *c;
+			runWidth += font->getCharSize(*c).w;
 		}
 	}
 }
@@ -152,7 +152,11 @@ void TextList::unpress(State *state)
  */
 void TextList::setCellColor(size_t row, size_t column, Uint8 color)
 {
-	_texts[row][column]->setColor(color);
+	_cells[row][column].color = color;
+	if (!_texts[row].empty())
+	{
+		_texts[row][column]->setColor(color);
+	}
 	_redraw = true;
 }
 
@@ -163,6 +167,10 @@ void TextList::setCellColor(size_t row, size_t column, Uint8 color)
  */
 void TextList::setRowColor(size_t row, Uint8 color)
 {
+	for (std::vector<TextListCell>::iterator i = _cells[row].begin(); i < _cells[row].end(); ++i)
+	{
+		i->color = color;
+	}
 	for (std::vector<Text*>::iterator i = _texts[row].begin(); i < _texts[row].end(); ++i)
 	{
 		(*i)->setColor(color);
@@ -178,7 +186,7 @@ void TextList::setRowColor(size_t row, Uint8 color)
  */
 std::string TextList::getCellText(size_t row, size_t column) const
 {
-	return _texts[row][column]->getText();
+	return getCell(row, column)->getText();
 }
 
 /**
@@ -189,7 +197,12 @@ std::string TextList::getCellText(size_t row, size_t column) const
  */
 void TextList::setCellText(size_t row, size_t column, const std::string &text)
 {
-	_texts[row][column]->setText(text);
+	_cells[row][column].text = text;
+	_cells[row][column].dot = false;
+	if (!_texts[row].empty())
+	{
+		_texts[row][column]->setText(text);
+	}
 	_redraw = true;
 }
 
@@ -200,7 +213,7 @@ void TextList::setCellText(size_t row, size_t column, const std::string &text)
  */
 int TextList::getColumnX(size_t column) const
 {
-	return getX() + _texts[0][column]->getX();
+	return getX() + getCell(0, column)->getX();
 }
 
 /**
@@ -210,7 +223,7 @@ int TextList::getColumnX(size_t column) const
  */
 int TextList::getRowY(size_t row) const
 {
-	return getY() + _texts[row][0]->getY();
+	return getY() + getCell(row, 0)->getY();
 }
 
 /**
@@ -220,7 +233,7 @@ int TextList::getRowY(size_t row) const
  */
 int TextList::getTextHeight(size_t row) const
 {
-	return _texts[row].front()->getTextHeight();
+	return getCell(row, 0)->getTextHeight();
 }
 
 /**
@@ -230,7 +243,7 @@ int TextList::getTextHeight(size_t row) const
  */
 int TextList::getNumTextLines(size_t row) const
 {
-	return _texts[row].front()->getNumLines();
+	return getCell(row, 0)->getNumLines();
 }
 
 /**
@@ -261,34 +274,28 @@ size_t TextList::getVisibleRows() const
 }
 
 /**
- * Adds a new row of text to the list, automatically creating
- * the required Text objects lined up where they need to be.
- * @param cols Number of columns.
- * @param ... Text for each cell in the new row.
+ * Makes the Text objects for a row of the list, lined up where they
+ * need to be. Rows that don't wrap are only made while they're visible.
+ * @param row Row number.
+ * @return Number of lines the row takes up.
  */
-void TextList::addRow(int cols, ...)
+int TextList::createRow(size_t row) const
 {
-	va_list args;
-	int ncols;
-	va_start(args, cols);
-	if (cols > 0)
-	{
-		ncols = cols;
-	}
-	else
-	{
-		ncols = 1;
-	}
-
-	std::vector<Text*> temp;
+	const std::vector<TextListCell> &cells = _cells[row];
+	std::vector<Text*> &texts = _texts[row];
 	// Positions are relative to list surface.
 	int rowX = 0, rowY = 0, rows = 1, rowHeight = 0;
-	if (!_texts.empty())
+	if (!_wrap)
+	{
+		_shownRows.push_back(row);
+		rowY = ((int)row - (int)_scroll) * (_font->getHeight() + _font->getSpacing());
+	}
+	else if (row > 0)
 	{
-		rowY = _texts.back().front()->getY() + _texts.back().front()->getHeight() + _font->getSpacing();
+		rowY = _texts[row - 1].front()->getY() + _texts[row - 1].front()->getHeight() + _font->getSpacing();
 	}
 
-	for (int i = 0; i < ncols; ++i)
+	for (size_t i = 0; i < cells.size(); ++i)
 	{
 		int width;
 		// Place text
@@ -303,11 +310,11 @@ void TextList::addRow(int cols, ...)
 		Text* txt = new Text(width, _font->getHeight(), _margin + rowX, rowY);
 		txt->setPalette(this->getPalette());
 		txt->initText(_big, _small, _lang);
-		txt->setColor(_color);
-		txt->setSecondaryColor(_color2);
-		if (_align[i])
+		txt->setColor(cells[i].color);
+		txt->setSecondaryColor(cells[i].color2);
+		if (cells[i].align)
 		{
-			txt->setAlign(_align[i]);
+			txt->setAlign(cells[i].align);
 		}
 		txt->setHighContrast(_contrast);
 		if (_font == _big)
@@ -318,8 +325,7 @@ void TextList::addRow(int cols, ...)
 		{
 			txt->setSmall();
 		}
-		if (cols > 0)
-			txt->setText(va_arg(args, char*));
+		txt->setText(cells[i].text);
 		// grab this before we enable word wrapping so we can use it to calculate
 		// the total row height below
 		int vmargin = _font->getHeight() - txt->getTextHeight();
@@ -332,18 +338,18 @@ void TextList::addRow(int cols, ...)
 		rowHeight = std::max(rowHeight, txt->getTextHeight() + vmargin);
 
 		// Places dots between text
-		if (_dot && i < cols - 1)
+		if (cells[i].dot)
 		{
 			std::string buf = txt->getText();
 			unsigned int w = txt->getTextWidth();
 			while (w < _columns[i])
 			{
-				if (_align[i] != ALIGN_RIGHT)
+				if (cells[i].align != ALIGN_RIGHT)
 				{
 				w += _font->getChar('.')->getCrop()->w + _font->getSpacing();
 				buf += '.';
 			}
-				if (_align[i] != ALIGN_LEFT)
+				if (cells[i].align != ALIGN_LEFT)
 				{
 					w += _font->getChar('.')->getCrop()->w + _font->getSpacing();
 					buf.insert(0, 1, '.');
@@ -352,7 +358,7 @@ void TextList::addRow(int cols, ...)
 			txt->setText(buf);
 		}
 
-		temp.push_back(txt);
+		texts.push_back(txt);
 		if (_condensed)
 		{
 			rowX += txt->getTextWidth();
@@ -364,20 +370,71 @@ void TextList::addRow(int cols, ...)
 	}
 
 	// ensure all elements in this row are the same height
-	for (int i = 0; i < cols; ++i)
+	for (std::vector<Text*>::iterator i = texts.begin(); i < texts.end(); ++i)
 	{
-		temp[i]->setHeight(rowHeight);
+		(*i)->setHeight(rowHeight);
 	}
+	return rows;
+}
 
-	_texts.push_back(temp);
-	for (int i = 0; i < rows; ++i)
+/**
+ * Gets the Text object of a cell, making the row if it isn't visible.
+ * @param row Row number.
+ * @param column Column number.
+ * @return Pointer to the Text.
+ */
+Text *TextList::getCell(size_t row, size_t column) const
+{
+	if (_texts[row].empty())
 	{
-		_rows.push_back(_texts.size() - 1);
+		createRow(row);
+	}
+	return _texts[row][column];
+}
+
+/**
+ * Deletes the Text objects of rows that don't wrap
+ * and are no longer visible.
+ * @param first First visible row.
+ * @param last Row after the last visible row.
+ */
+void TextList::releaseRows(size_t first, size_t last)
+{
+	std::vector<size_t>::iterator kept = _shownRows.begin();
+	for (std::vector<size_t>::iterator i = _shownRows.begin(); i < _shownRows.end(); ++i)
+	{
+		if (*i < first || *i >= last)
+		{
+			for (std::vector<Text*>::iterator j = _texts[*i].begin(); j < _texts[*i].end(); ++j)
+			{
+				delete *j;
+			}
+			_texts[*i].clear();
+		}
+		else
+		{
+			*kept = *i;
+			++kept;
+		}
 	}
+	_shownRows.erase(kept, _shownRows.end());
+}
 
+/**
+ * Adds arrow buttons until there's a pair for every row that can
+ * be on screen. Rows that don't wrap share the pairs, since they
+ * all take up the same space.
+ */
+void TextList::addArrows()
+{
+	size_t needed = _texts.size();
+	if (!_wrap)
+	{
+		needed = std::min(needed, _visibleRows);
+	}
 	// Place arrow buttons
 	// Position defined w.r.t. main window, NOT TextList.
-	if (_arrowPos != -1)
+	while (_arrowPos != -1 && _arrowLeft.size() < needed)
 	{
 		ArrowShape shape1, shape2;
 		if (_arrowType == ARROW_VERTICAL)
@@ -407,7 +464,54 @@ void TextList::addRow(int cols, ...)
 		a2->onMouseRelease(_rightRelease);
 		_arrowRight.push_back(a2);
 	}
+}
+
+/**
+ * Adds a new row of text to the list. Rows that wrap get their
+ * Text objects right away, since the lines they take up depend on them.
+ * @param cols Number of columns.
+ * @param ... Text for each cell in the new row.
+ */
+void TextList::addRow(int cols, ...)
+{
+	va_list args;
+	int ncols;
+	va_start(args, cols);
+	if (cols > 0)
+	{
+		ncols = cols;
+	}
+	else
+	{
+		ncols = 1;
+	}
+
+	std::vector<TextListCell> cells;
+	for (int i = 0; i < ncols; ++i)
+	{
+		TextListCell cell;
+		if (cols > 0)
+			cell.text = va_arg(args, char*);
+		cell.color = _color;
+		cell.color2 = _color2;
+		cell.align = _align[i];
+		cell.dot = _dot && i < cols - 1;
+		cells.push_back(cell);
+	}
+	_cells.push_back(cells);
+	_texts.push_back(std::vector<Text*>());
 
+	int rows = 1;
+	if (_wrap)
+	{
+		rows = createRow(_texts.size() - 1);
+	}
+	for (int i = 0; i < rows; ++i)
+	{
+		_rows.push_back(_texts.size() - 1);
+	}
+
+	addArrows();
 	_redraw = true;
 	va_end(args);
 	updateArrows();
@@ -514,6 +618,13 @@ void TextList::setColor(Uint8 color)
 	_up->setColor(color);
 	_down->setColor(color);
 	_scrollbar->setColor(color);
+	for (std::vector< std::vector<TextListCell> >::iterator u = _cells.begin(); u < _cells.end(); ++u)
+	{
+		for (std::vector<TextListCell>::iterator v = u->begin(); v < u->end(); ++v)
+		{
+			v->color = color;
+		}
+	}
 	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
 	{
 		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
@@ -823,6 +934,8 @@ void TextList::clearList()
 	}
 	scrollUp(true, false);
 	_texts.clear();
+	_cells.clear();
+	_shownRows.clear();
 	_rows.clear();
 	_redraw = true;
 }
@@ -909,6 +1022,7 @@ void TextList::updateVisible()
 	{
 		_visibleRows++;
 	}
+	addArrows();
 	updateArrows();
 }
 
@@ -946,6 +1060,7 @@ void TextList::draw()
 		}
 		for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows; ++i)
 		{
+			getCell(i, 0);
 			for (std::vector<Text*>::iterator j = _texts[i].begin(); j < _texts[i].end(); ++j)
 			{
 				(*j)->setY(y);
@@ -960,6 +1075,10 @@ void TextList::draw()
 				y += _font->getHeight() + _font->getSpacing();
 			}
 		}
+		if (!_wrap)
+		{
+			releaseRows(_rows[_scroll], _rows[_scroll] + _visibleRows);
+		}
 	}
 }
 
@@ -984,16 +1103,17 @@ void TextList::blit(Surface *surface)
 				y -= _font->getHeight() + _font->getSpacing();
 			}
 			int maxY = getY() + getHeight();
+			size_t first = _wrap ? 0 : _rows[_scroll];
 			for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows && y < maxY; ++i)
 			{
-				_arrowLeft[i]->setY(y);
-				_arrowRight[i]->setY(y);
+				_arrowLeft[i - first]->setY(y);
+				_arrowRight[i - first]->setY(y);
 
 				if (y >= getY())
 				{
 					// only blit arrows that belong to texts that have their first row on-screen
-					_arrowLeft[i]->blit(surface);
-					_arrowRight[i]->blit(surface);
+					_arrowLeft[i - first]->blit(surface);
+					_arrowRight[i - first]->blit(surface);
 				}
 
 				if (!_texts[i].empty())
@@ -1040,10 +1160,11 @@ void TextList::handle(Action *action, State *state)
 				++endArrowIdx;
 			}
 		}
+		size_t first = _wrap ? 0 : _rows[_scroll];
 		for (size_t i = startArrowIdx; i < endArrowIdx; ++i)
 		{
-			_arrowLeft[i]->handle(action, state);
-			_arrowRight[i]->handle(action, state);
+			_arrowLeft[i - first]->handle(action, state);
+			_arrowRight[i - first]->handle(action, state);
 		}
 	}
 }
@@ -1155,7 +1276,7 @@ void TextList::mouseOver(Action *action, State *state)
 		_selRow = std::max(0, (int)(_scroll + (int)floor(action->getRelativeYMouse() / (rowHeight * action->getYScale()))));
 		if (_selRow < _rows.size())
 		{
-			Text *selText = _texts[_rows[_selRow]].front();
+			Text *selText = getCell(_rows[_selRow], 0);
 			int y = getY() + selText->getY();
 			int actualHeight = selText->getHeight() + _font->getSpacing(); //current line height
 			if (y < getY() || y + actualHeight > getY() + getHeight())
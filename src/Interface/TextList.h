@@ -31,16 +31,32 @@ class ArrowButton;
 class ComboBox;
 class ScrollBar;
 
+/**
+ * Contents of a cell in a TextList, kept so the
+ * Text can be made again when the row is shown.
+ */
+struct TextListCell
+{
+	std::string text;
+	Uint8 color, color2;
+	TextHAlign align;
+	bool dot;
+};
+
 /**
  * List of Text's split into columns.
  * Contains a set of Text's that are automatically lined up by
  * rows and columns, like a big table, making it easy to manage
  * them together.
+ * Rows that don't wrap only get their Text's while they're
+ * visible, so lists with thousands of rows stay cheap.
  */
 class TextList : public InteractiveSurface
 {
 private:
-	std::vector< std::vector<Text*> > _texts;
+	mutable std::vector< std::vector<Text*> > _texts;
+	std::vector< std::vector<TextListCell> > _cells;
+	mutable std::vector<size_t> _shownRows;
 	std::vector<size_t> _columns, _rows;
 	Font *_big, *_small, *_font;
 	Language *_lang;
@@ -60,6 +76,14 @@ private:
 	int _arrowsLeftEdge, _arrowsRightEdge;
 	ComboBox *_comboBox;
 
+	/// Makes the Text's for a row.
+	int createRow(size_t row) const;
+	/// Gets the Text of a cell, making it if needed.
+	Text *getCell(size_t row, size_t column) const;
+	/// Deletes the Text's of rows that aren't visible anymore.
+	void releaseRows(size_t first, size_t last);
+	/// Adds the arrow buttons the rows need.
+	void addArrows();
 	/// Updates the arrow buttons.
 	void updateArrows();
 	/// Updates the visible rows.
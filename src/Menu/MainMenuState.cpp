@@ -29,9 +29,11 @@
 #include "NewGameState.h"
 #include "NewBattleState.h"
 #include "ListLoadState.h"
+#include "LoadGameState.h"
 #include "OptionsVideoState.h"
 #include "ModListState.h"
 #include "../Engine/Options.h"
+#include "../Battlescape/BattleReplay.h"
 
 namespace OpenXcom
 {
@@ -40,7 +42,16 @@ void GoToMainMenuState::init()
 {
 	Screen::updateScale(Options::geoscapeScale, Options::baseXGeoscape, Options::baseYGeoscape, true);
 	_game->getScreen()->resetDisplay(false);
-	_game->setState(new MainMenuState);
+	MainMenuState *menu = new MainMenuState;
+	_game->setState(menu);
+
+	// go straight to the battle being played back, if any
+	static bool replayLoaded = false;
+	if (!replayLoaded && !Options::getReplay().empty())
+	{
+		replayLoaded = true;
+		_game->pushState(new LoadGameState(OPT_MENU, BattleReplay::getSaveName(Options::getReplay()), menu->getPalette()));
+	}
 }
 
 /**
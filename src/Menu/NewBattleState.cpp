@@ -286,6 +286,11 @@ void NewBattleState::load(const std::string &filename)
 				Base *base = new Base(mod);
 				base->load(doc["base"], save, false);
 				save->getBases()->push_back(base);
+				save->getTargetGrid()->add(base);
+				for (std::vector<Craft*>::iterator j = base->getCrafts()->begin(); j != base->getCrafts()->end(); ++j)
+				{
+					save->getTargetGrid()->add(*j);
+				}
 
 				// Add research
 				const std::vector<std::string> &research = mod->getResearchList();
@@ -312,6 +317,7 @@ void NewBattleState::load(const std::string &filename)
 					std::string craftType = _crafts[_cbxCraft->getSelected()];
 					_craft = new Craft(_game->getMod()->getCraft(craftType), base, save->getId(craftType));
 					base->getCrafts()->push_back(_craft);
+					save->getTargetGrid()->add(_craft);
 				}
 				else
 				{
@@ -387,6 +393,7 @@ void NewBattleState::initSave()
 	const YAML::Node &starter = _game->getMod()->getStartingBase();
 	base->load(starter, save, true, true);
 	save->getBases()->push_back(base);
+	save->getTargetGrid()->add(base);
 
 	// Kill everything we don't want in this base
 	for (std::vector<Soldier*>::iterator i = base->getSoldiers()->begin(); i != base->getSoldiers()->end(); ++i) delete (*i);
@@ -397,6 +404,7 @@ void NewBattleState::initSave()
 
 	_craft = new Craft(mod->getCraft(_crafts[_cbxCraft->getSelected()]), base, 1);
 	base->getCrafts()->push_back(_craft);
+	save->getTargetGrid()->add(_craft);
 
 	// Generate soldiers
 	for (int i = 0; i < 30; ++i)
@@ -493,6 +501,7 @@ void NewBattleState::btnOkClick(Action *)
 		_craft->setDestination(b);
 		bgen.setAlienBase(b);
 		_game->getSavedGame()->getAlienBases()->push_back(b);
+		_game->getSavedGame()->getTargetGrid()->add(b);
 	}
 	// ufo assault
 	else if (_craft && _game->getMod()->getUfo(_missionTypes[_cbxMission->getSelected()]))
@@ -513,6 +522,7 @@ void NewBattleState::btnOkClick(Action *)
 			bgame->setMissionType("STR_UFO_CRASH_RECOVERY");
 		}
 		_game->getSavedGame()->getUfos()->push_back(u);
+		_game->getSavedGame()->getTargetGrid()->add(u);
 	}
 	// mission site
 	else
@@ -525,6 +535,7 @@ void NewBattleState::btnOkClick(Action *)
 		_craft->setDestination(m);
 		bgen.setMissionSite(m);
 		_game->getSavedGame()->getMissionSites()->push_back(m);
+		_game->getSavedGame()->getTargetGrid()->add(m);
 	}
 
 	if (_craft)
@@ -133,16 +133,15 @@ void ExtraSounds::loadSound(SoundSet *set, int index, const std::string &fileNam
 	}
 
 	const std::string &fullPath = FileMap::getFilePath(fileName);
-	Sound *sound = set->getSound(indexWithOffset);
-	if (sound)
+	if (set->hasSound(indexWithOffset))
 	{
 		Log(LOG_VERBOSE) << "Replacing sound: " << index << ", using index: " << indexWithOffset;
 	}
 	else
 	{
 		Log(LOG_VERBOSE) << "Adding sound: " << index << ", using index: " << indexWithOffset;
-		sound = set->addSound(indexWithOffset);
 	}
+	Sound *sound = set->addSound(indexWithOffset);
 	sound->load(fullPath);
 }
 
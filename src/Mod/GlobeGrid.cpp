@@ -0,0 +1,200 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GlobeGrid.h"
+#include "../fmath.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates an empty grid with all the cells allocated.
+ */
+GlobeGrid::GlobeGrid() : _cells(CELLS_LON * CELLS_LAT), _size(0)
+{
+}
+
+/**
+ *
+ */
+GlobeGrid::~GlobeGrid()
+{
+}
+
+/**
+ * Removes everything from the grid, so it can be filled
+ * with a new set of entries.
+ * @param entries Number of entries that will be added.
+ */
+void GlobeGrid::reset(size_t entries)
+{
+	for (std::vector<std::vector<size_t> >::iterator i = _cells.begin(); i != _cells.end(); ++i)
+	{
+		i->clear();
+	}
+	_size = entries;
+}
+
+/**
+ * Gets the number of entries the grid was set up for.
+ * @return Number of entries.
+ */
+size_t GlobeGrid::size() const
+{
+	return _size;
+}
+
+/**
+ * Converts a longitude into a grid column,
+ * wrapping it around the globe.
+ * @param lon Longitude in radians.
+ * @return Column index.
+ */
+int GlobeGrid::getColumn(double lon)
+{
+	double l = std::fmod(lon, 2 * M_PI);
+	if (l < 0)
+		l += 2 * M_PI;
+	int col = (int)(l * CELLS_LON / (2 * M_PI));
+	return Clamp(col, 0, CELLS_LON - 1);
+}
+
+/**
+ * Converts a latitude into a grid row.
+ * @param lat Latitude in radians.
+ * @return Row index.
+ */
+int GlobeGrid::getRow(double lat)
+{
+	int row = (int)std::floor((lat + M_PI_2) * CELLS_LAT / M_PI);
+	return Clamp(row, 0, CELLS_LAT - 1);
+}
+
+/**
+ * Adds an entry to every cell in a block, with the
+ * columns wrapping around the globe.
+ * @param id Entry index.
+ * @param col1 First column.
+ * @param col2 Last column (can be lower than the first one if wrapping).
+ * @param row1 First row.
+ * @param row2 Last row.
+ */
+void GlobeGrid::addCells(size_t id, int col1, int col2, int row1, int row2)
+{
+	int cols = (col2 - col1 + CELLS_LON) % CELLS_LON + 1;
+	for (int row = row1; row <= row2; ++row)
+	{
+		for (int c = 0; c < cols; ++c)
+		{
+			std::vector<size_t> &cell = _cells[row * CELLS_LON + (col1 + c) % CELLS_LON];
+			if (cell.empty() || cell.back() != id)
+			{
+				cell.push_back(id);
+			}
+		}
+	}
+}
+
+/**
+ * Adds an entry covering a lon/lat rectangle, like the ones
+ * used for regions and countries. If the minimum longitude is bigger
+ * than the maximum, the rectangle wraps around the 0 meridian.
+ * @param id Entry index.
+ * @param lonMin Minimum longitude in radians.
+ * @param lonMax Maximum longitude in radians.
+ * @param latMin Minimum latitude in radians.
+ * @param latMax Maximum latitude in radians.
+ */
+void GlobeGrid::addArea(size_t id, double lonMin, double lonMax, double latMin, double latMax)
+{
+	int col1 = getColumn(lonMin), col2 = getColumn(lonMax);
+	if (lonMin <= lonMax && lonMax - lonMin >= 2 * M_PI)
+	{
+		col1 = 0;
+		col2 = CELLS_LON - 1;
+	}
+	addCells(id, col1, col2, getRow(std::min(latMin, latMax)), getRow(std::max(latMin, latMax)));
+}
+
+/**
+ * Adds an entry covering a globe polygon. The edges are great circle
+ * arcs, so they're sampled to account for them bulging towards the poles.
+ * Polygons that go around a pole cover every longitude up to it.
+ * @param id Entry index.
+ * @param lon Longitudes of the points in radians.
+ * @param lat Latitudes of the points in radians.
+ * @param points Number of points.
+ */
+void GlobeGrid::addPolygon(size_t id, const double *lon, const double *lat, int points)
+{
+	const int SAMPLES = 8;
+	if (points <= 0)
+		return;
+	double lonMin = 0, lonMax = 0, latMin = lat[0], latMax = lat[0];
+	for (int i = 0; i < points; ++i)
+	{
+		int j = (i + 1) % points;
+		double x1 = std::cos(lat[i]) * std::cos(lon[i]), y1 = std::cos(lat[i]) * std::sin(lon[i]), z1 = std::sin(lat[i]);
+		double x2 = std::cos(lat[j]) * std::cos(lon[j]), y2 = std::cos(lat[j]) * std::sin(lon[j]), z2 = std::sin(lat[j]);
+		for (int s = 0; s < SAMPLES; ++s)
+		{
+			double t = (double)s / SAMPLES;
+			double x = x1 + (x2 - x1) * t, y = y1 + (y2 - y1) * t, z = z1 + (z2 - z1) * t;
+			double len = std::sqrt(x * x + y * y + z * z);
+			if (len <= 0)
+				continue;
+			double la = std::asin(Clamp(z / len, -1.0, 1.0));
+			// longitudes relative to the first point, so the polygon doesn't split at the 0 meridian
+			double dl = std::atan2(y, x) - lon[0];
+			while (dl > M_PI) dl -= 2 * M_PI;
+			while (dl < -M_PI) dl += 2 * M_PI;
+			latMin = std::min(latMin, la);
+			latMax = std::max(latMax, la);
+			lonMin = std::min(lonMin, dl);
+			lonMax = std::max(lonMax, dl);
+		}
+	}
+	// pad by a cell for rounding in the sampling
+	double padLon = 2 * M_PI / CELLS_LON, padLat = M_PI / CELLS_LAT;
+	if (lonMax - lonMin + 2 * padLon >= M_PI)
+	{
+		if (latMin + latMax > 0)
+			latMax = M_PI_2;
+		else
+			latMin = -M_PI_2;
+		addCells(id, 0, CELLS_LON - 1, getRow(latMin - padLat), getRow(latMax + padLat));
+	}
+	else
+	{
+		addCells(id, getColumn(lon[0] + lonMin - padLon), getColumn(lon[0] + lonMax + padLon), getRow(latMin - padLat), getRow(latMax + padLat));
+	}
+}
+
+/**
+ * Gets the entries whose bounds include a point. It's up to
+ * the caller to do the exact check on each of them.
+ * @param lon Longitude in radians.
+ * @param lat Latitude in radians.
+ * @return List of entry indices, in insertion order.
+ */
+const std::vector<size_t> &GlobeGrid::getCell(double lon, double lat) const
+{
+	return _cells[getRow(lat) * CELLS_LON + getColumn(lon)];
+}
+
+}
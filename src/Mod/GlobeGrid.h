@@ -0,0 +1,64 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <cstddef>
+
+namespace OpenXcom
+{
+
+/**
+ * Spatial index over the surface of the globe.
+ * Splits the globe into a fixed lat/lon grid and keeps, for every
+ * cell, the indices of all the entries (polygons, regions, countries...)
+ * that may overlap it, in insertion order. Point queries then only
+ * need to test the few entries of a single cell.
+ */
+class GlobeGrid
+{
+private:
+	static const int CELLS_LON = 180;
+	static const int CELLS_LAT = 90;
+	std::vector<std::vector<size_t> > _cells;
+	size_t _size;
+
+	/// Gets the column of a longitude.
+	static int getColumn(double lon);
+	/// Gets the row of a latitude.
+	static int getRow(double lat);
+	/// Adds an entry to a block of cells.
+	void addCells(size_t id, int col1, int col2, int row1, int row2);
+public:
+	/// Creates an empty grid.
+	GlobeGrid();
+	/// Cleans up the grid.
+	~GlobeGrid();
+	/// Clears the grid to hold a new set of entries.
+	void reset(size_t entries);
+	/// Gets the number of entries in the grid.
+	size_t size() const;
+	/// Adds an entry covering a lon/lat rectangle.
+	void addArea(size_t id, double lonMin, double lonMax, double latMin, double latMax);
+	/// Adds an entry covering a spherical polygon.
+	void addPolygon(size_t id, const double *lon, const double *lat, int points);
+	/// Gets the entries that may contain a point.
+	const std::vector<size_t> &getCell(double lon, double lat) const;
+};
+
+}
@@ -20,10 +20,12 @@
 #include "MapData.h"
 #include <fstream>
 #include <sstream>
+#include <cstring>
 #include <SDL_endian.h>
 #include "../Engine/Exception.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/FileMap.h"
+#include "../Engine/MappedFile.h"
 #include "../Engine/Logger.h"
 
 namespace OpenXcom
@@ -156,14 +158,15 @@ void MapDataSet::loadData(MCDPatch *patch)
 
 	// Load Terrain Data from MCD file
 	std::string fname = "TERRAIN/" + _name + ".MCD";
-	std::ifstream mapFile(FileMap::getFilePath(fname).c_str(), std::ios::in | std::ios::binary);
+	const MappedFile *mapFile = FileMap::mapFile(FileMap::getFilePath(fname));
 	if (!mapFile)
 	{
 		throw Exception(fname + " not found");
 	}
 
-	while (mapFile.read((char*)&mcd, sizeof(MCD)))
+	for (size_t offset = 0; offset + sizeof(MCD) <= mapFile->getSize(); offset += sizeof(MCD))
 	{
+		memcpy(&mcd, mapFile->getData() + offset, sizeof(MCD));
 		MapData *to = new MapData(this);
 		_objects.push_back(to);
 
@@ -207,14 +210,6 @@ void MapDataSet::loadData(MCDPatch *patch)
 		objNumber++;
 	}
 
-
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid MCD file " + fname);
-	}
-
-	mapFile.close();
-
 	// apply any ruleset patches before validation
 	if (patch)
 	{
@@ -949,6 +949,7 @@ void Mod::loadAll(const std::vector< std::pair< std::string, std::vector<std::st
 	//back master
 	_modCurrent = &_modData.at(0);
 	sortLists();
+	_globe->buildPolygonGrid();
 	loadExtraResources();
 	modResources();
 }
@@ -1671,6 +1672,11 @@ SavedGame *Mod::newSave() const
 	Base *base = new Base(this);
 	base->load(_startingBase, save, true);
 	save->getBases()->push_back(base);
+	save->getTargetGrid()->add(base);
+	for (std::vector<Craft*>::iterator i = base->getCrafts()->begin(); i != base->getCrafts()->end(); ++i)
+	{
+		save->getTargetGrid()->add(*i);
+	}
 
 	// Correct IDs
 	for (std::vector<Craft*>::const_iterator i = base->getCrafts()->begin(); i != base->getCrafts()->end(); ++i)
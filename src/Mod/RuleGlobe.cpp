@@ -158,6 +158,55 @@ std::list<Polyline*> *RuleGlobe::getPolylines()
 	return &_polylines;
 }
 
+/**
+ * Builds a lat/lon grid of the world polygons so point lookups
+ * don't have to go through every polygon on the globe.
+ * Must be called again whenever the polygon list changes.
+ */
+void RuleGlobe::buildPolygonGrid()
+{
+	_polygonIndex.assign(_polygons.begin(), _polygons.end());
+	_polygonGrid.reset(_polygonIndex.size());
+	std::vector<double> lon, lat;
+	for (size_t i = 0; i < _polygonIndex.size(); ++i)
+	{
+		Polygon *poly = _polygonIndex[i];
+		lon.resize(poly->getPoints());
+		lat.resize(poly->getPoints());
+		for (int j = 0; j < poly->getPoints(); ++j)
+		{
+			lon[j] = poly->getLongitude(j);
+			lat[j] = poly->getLatitude(j);
+		}
+		if (poly->getPoints() > 0)
+		{
+			_polygonGrid.addPolygon(i, &lon[0], &lat[0], poly->getPoints());
+		}
+	}
+}
+
+/**
+ * Gets all the world polygons whose bounds include a certain point,
+ * in the same order as the polygon list.
+ * @param lon Longitude in radians.
+ * @param lat Latitude in radians.
+ * @return List of polygon indices.
+ */
+const std::vector<size_t> &RuleGlobe::getPolygonsAt(double lon, double lat) const
+{
+	return _polygonGrid.getCell(lon, lat);
+}
+
+/**
+ * Gets a world polygon by its index in the polygon grid.
+ * @param i Polygon index.
+ * @return Pointer to the polygon.
+ */
+Polygon *RuleGlobe::getIndexedPolygon(size_t i) const
+{
+	return _polygonIndex[i];
+}
+
 /**
  * Loads a series of map polar coordinates in X-Com format,
  * converts them and stores them in a set of polygons.
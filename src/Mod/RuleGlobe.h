@@ -20,6 +20,7 @@
 #include <list>
 #include <string>
 #include <yaml-cpp/yaml.h>
+#include "GlobeGrid.h"
 
 namespace OpenXcom
 {
@@ -39,6 +40,8 @@ private:
 	std::list<Polygon*> _polygons;
 	std::list<Polyline*> _polylines;
 	std::map<int, Texture*> _textures;
+	std::vector<Polygon*> _polygonIndex;
+	GlobeGrid _polygonGrid;
 public:
 	/// Creates a blank globe ruleset.
 	RuleGlobe();
@@ -50,6 +53,12 @@ public:
 	std::list<Polygon*> *getPolygons();
 	/// Gets the list of world polylines.
 	std::list<Polyline*> *getPolylines();
+	/// Builds the spatial index of world polygons.
+	void buildPolygonGrid();
+	/// Gets the indices of the world polygons that may contain a point.
+	const std::vector<size_t> &getPolygonsAt(double lon, double lat) const;
+	/// Gets an indexed world polygon.
+	Polygon *getIndexedPolygon(size_t i) const;
 	/// Loads a set of polygons from a DAT file.
 	void loadDat(const std::string &filename);
 	/// Gets a specific world texture.
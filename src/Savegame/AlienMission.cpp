@@ -176,6 +176,7 @@ void AlienMission::think(Game &engine, const Globe &globe)
 	{
 		//Some missions may not spawn a UFO!
 		game.getUfos()->push_back(ufo);
+		game.getTargetGrid()->add(ufo);
 	}
 	else if ((mod.getDeployment(wave.ufoType) && !mod.getUfo(wave.ufoType) && !mod.getDeployment(wave.ufoType)->getMarkerName().empty()) // a mission site that we want to spawn directly
 			|| (_rule.getObjective() == OBJECTIVE_SITE && wave.objective)) // or we want to spawn one at random according to our terrain
@@ -653,21 +654,15 @@ void AlienMission::addScore(double lon, double lat, SavedGame &game) const
 {
 	if (_rule.getObjective() == OBJECTIVE_INFILTRATION)
 		return; // pact score is a special case
-	for (std::vector<Region *>::iterator region = game.getRegions()->begin(); region != game.getRegions()->end(); ++region)
+	Region *region = game.locateRegion(lon, lat);
+	if (region)
 	{
-		if ((*region)->getRules()->insideRegion(lon, lat))
-		{
-			(*region)->addActivityAlien(_rule.getPoints());
-			break;
-		}
+		region->addActivityAlien(_rule.getPoints());
 	}
-	for (std::vector<Country *>::iterator country = game.getCountries()->begin(); country != game.getCountries()->end(); ++country)
+	Country *country = game.locateCountry(lon, lat);
+	if (country)
 	{
-		if ((*country)->getRules()->insideCountry(lon, lat))
-		{
-			(*country)->addActivityAlien(_rule.getPoints());
-			break;
-		}
+		country->addActivityAlien(_rule.getPoints());
 	}
 }
 
@@ -701,6 +696,7 @@ void AlienMission::spawnAlienBase(Game &engine, const MissionArea &area, std::pa
 	ab->setLongitude(pos.first);
 	ab->setLatitude(pos.second);
 	game.getAlienBases()->push_back(ab);
+	game.getTargetGrid()->add(ab);
 	addScore(ab->getLongitude(), ab->getLatitude(), game);
 }
 
@@ -820,6 +816,7 @@ MissionSite *AlienMission::spawnMissionSite(SavedGame &game, AlienDeployment *de
 		missionSite->setTexture(area.texture);
 		missionSite->setCity(area.name);
 		game.getMissionSites()->push_back(missionSite);
+		game.getTargetGrid()->add(missionSite);
 		return missionSite;
 	}
 	return 0;
@@ -980,6 +980,24 @@ int Base::getLongRangeDetection() const
 	return total;
 }
 
+/**
+ * Returns the range of the longest reaching
+ * detection facility in the base.
+ * @return Radar range in nautical miles.
+ */
+int Base::getMaxRadarRange() const
+{
+	int range = 0;
+	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
+	{
+		if ((*i)->getBuildTime() == 0)
+		{
+			range = std::max(range, (*i)->getRules()->getRadarRange());
+		}
+	}
+	return range;
+}
+
 /**
  * Returns the total amount of craft of
  * a certain type stored in the base.
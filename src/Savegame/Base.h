@@ -151,6 +151,8 @@ public:
 	int getShortRangeDetection() const;
 	/// Gets the base's long range detection.
 	int getLongRangeDetection() const;
+	/// Gets the base's longest radar range.
+	int getMaxRadarRange() const;
 	/// Gets the base's crafts of a certain type.
 	int getCraftCount(const std::string &craft) const;
 	/// Gets the base's craft maintenance.
@@ -337,8 +337,8 @@ void Craft::setBase(Base *base, bool move)
 	_base = base;
 	if (move)
 	{
-		_lon = base->getLongitude();
-		_lat = base->getLatitude();
+		setLongitude(base->getLongitude());
+		setLatitude(base->getLatitude());
 	}
 }
 
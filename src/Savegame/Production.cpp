@@ -128,6 +128,7 @@ productionProgress_e Production::step(Base * b, SavedGame * g, const Mod *m)
 					Craft *craft = new Craft(m->getCraft(i->first, true), b, g->getId(i->first));
 					craft->setStatus("STR_REFUELLING");
 					b->getCrafts()->push_back(craft);
+					g->getTargetGrid()->add(craft);
 					break;
 				}
 				else
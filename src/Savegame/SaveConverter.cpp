@@ -669,12 +669,14 @@ void SaveConverter::loadDatLoc()
 			abase->setAlienRace(_rules->getCrews()[dat]);
 			abase->setDiscovered(detected);
 			_save->getAlienBases()->push_back(abase);
+			_save->getTargetGrid()->add(abase);
 			target = abase;
 			break;
 		case TARGET_WAYPOINT:
 			waypoint = new Waypoint();
 			waypoint->setId(id);
 			_save->getWaypoints()->push_back(waypoint);
+			_save->getTargetGrid()->add(waypoint);
 			target = waypoint;
 			break;
 		case TARGET_TERROR:
@@ -700,6 +702,7 @@ void SaveConverter::loadDatLoc()
 			mission->setSecondsRemaining(timer * 3600);
 			mission->setDetected(detected);
 			_save->getMissionSites()->push_back(mission);
+			_save->getTargetGrid()->add(mission);
 			target = mission;
 		}
 		if (target != 0)
@@ -773,6 +776,7 @@ void SaveConverter::loadDatBase()
 		if (*i != 0)
 		{
 			_save->getBases()->push_back(*i);
+			_save->getTargetGrid()->add(*i);
 		}
 	}
 }
@@ -953,6 +957,7 @@ void SaveConverter::loadDatCraft()
 					Base *b = dynamic_cast<Base*>(_targets[base]);
 					craft->setBase(b, false);
 					b->getCrafts()->push_back(craft);
+					_save->getTargetGrid()->add(craft);
 				}
 			}
 			Ufo *ufo = dynamic_cast<Ufo*>(_targets[i]);
@@ -1014,6 +1019,7 @@ void SaveConverter::loadDatCraft()
 				}
 
 				_save->getUfos()->push_back(ufo);
+				_save->getTargetGrid()->add(ufo);
 			}
 		}
 	}
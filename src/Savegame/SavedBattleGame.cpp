@@ -18,6 +18,7 @@
  */
 #include <assert.h>
 #include <vector>
+#include <algorithm>
 #include "BattleItem.h"
 #include "SavedBattleGame.h"
 #include "SavedGame.h"
@@ -521,11 +522,13 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool
 	_mapsize_y = mapsize_y;
 	_mapsize_z = mapsize_z;
 	_tiles = new Tile*[_mapsize_z * _mapsize_y * _mapsize_x];
+	_activeTiles.clear();
 	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
 	{
 		Position pos;
 		getTileCoords(i, &pos.x, &pos.y, &pos.z);
 		_tiles[i] = new Tile(pos);
+		_tiles[i]->setActiveList(&_activeTiles);
 	}
 
 }
@@ -1360,20 +1363,61 @@ Node *SavedBattleGame::getPatrolNode(bool scout, BattleUnit *unit, Node *fromNod
 	}
 }
 
+/**
+ * Sorts tiles in the order they are stored in the map.
+ * @param a First tile.
+ * @param b Second tile.
+ * @return True if tile a comes before tile b.
+ */
+static bool compareTileOrder(const Tile *a, const Tile *b)
+{
+	const Position &pa = a->getPosition(), &pb = b->getPosition();
+	if (pa.z != pb.z)
+		return pa.z < pb.z;
+	if (pa.y != pb.y)
+		return pa.y < pb.y;
+	return pa.x < pb.x;
+}
+
+/**
+ * Gets the strongest light given off by the terrain and flares of a tile.
+ * @param tile Pointer to the tile.
+ * @return Light power.
+ */
+static int getTerrainLight(Tile *tile)
+{
+	int light = 0;
+	if (tile->getMapData(O_FLOOR))
+		light = std::max(light, tile->getMapData(O_FLOOR)->getLightSource());
+	if (tile->getMapData(O_OBJECT))
+		light = std::max(light, tile->getMapData(O_OBJECT)->getLightSource());
+	for (std::vector<BattleItem*>::iterator i = tile->getInventory()->begin(); i != tile->getInventory()->end(); ++i)
+	{
+		if ((*i)->getRules()->getBattleType() == BT_FLARE)
+			light = std::max(light, (*i)->getRules()->getPower());
+	}
+	return light;
+}
+
 /**
  * Carries out new turn preparations such as fire and smoke spreading.
+ * Only the tiles that have fire, smoke or danger on them are looked at,
+ * in the same order as the map so the results don't depend on it.
  */
 void SavedBattleGame::prepareNewTurn()
 {
 	std::vector<Tile*> tilesOnFire;
 	std::vector<Tile*> tilesOnSmoke;
+	std::vector<Position> lightChanges;
+	int lightPower = 0;
 
 	// prepare a list of tiles on fire
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	std::sort(_activeTiles.begin(), _activeTiles.end(), compareTileOrder);
+	for (std::vector<Tile*>::iterator i = _activeTiles.begin(); i != _activeTiles.end(); ++i)
 	{
-		if (getTiles()[i]->getFire() > 0)
+		if ((*i)->getFire() > 0)
 		{
-			tilesOnFire.push_back(getTiles()[i]);
+			tilesOnFire.push_back(*i);
 		}
 	}
 
@@ -1399,13 +1443,21 @@ void SavedBattleGame::prepareNewTurn()
 					if (t && getTileEngine()->horizontalBlockage((*i), t, DT_IN) == 0)
 					{
 						// attempt to set this tile on fire
+						bool burning = t->getFire() != 0;
 						t->ignite((*i)->getSmoke());
+						if (!burning && t->getFire() != 0)
+						{
+							lightChanges.push_back(t->getPosition());
+						}
 					}
 				}
 			}
 			// fire has burnt out
 			else
 			{
+				// the light of the fire, of anything burnt away and of any flares falling down is gone
+				lightChanges.push_back((*i)->getPosition());
+				lightPower = std::max(lightPower, getTerrainLight(*i));
 				(*i)->setSmoke(0);
 				// burn this tile, and any object in it, if it's not fireproof/indestructible.
 				if ((*i)->getMapData(O_OBJECT))
@@ -1432,19 +1484,21 @@ void SavedBattleGame::prepareNewTurn()
 						}
 					}
 				}
+				lightPower = std::max(lightPower, getTerrainLight(*i));
 				getTileEngine()->applyGravity(*i);
 			}
 		}
 	}
 
 	// prepare a list of tiles on fire/with smoke in them (smoke acts as fire intensity)
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	std::sort(_activeTiles.begin(), _activeTiles.end(), compareTileOrder);
+	for (std::vector<Tile*>::iterator i = _activeTiles.begin(); i != _activeTiles.end(); ++i)
 	{
-		if (getTiles()[i]->getSmoke() > 0)
+		if ((*i)->getSmoke() > 0)
 		{
-			tilesOnSmoke.push_back(getTiles()[i]);
+			tilesOnSmoke.push_back(*i);
 		}
-		getTiles()[i]->setDangerous(false);
+		(*i)->setDangerous(false);
 	}
 
 	// now make the smoke spread.
@@ -1502,14 +1556,30 @@ void SavedBattleGame::prepareNewTurn()
 	if (!tilesOnFire.empty() || !tilesOnSmoke.empty())
 	{
 		// do damage to units, average out the smoke, etc.
-		for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+		std::sort(_activeTiles.begin(), _activeTiles.end(), compareTileOrder);
+		for (std::vector<Tile*>::iterator i = _activeTiles.begin(); i != _activeTiles.end(); ++i)
+		{
+			if ((*i)->getSmoke() != 0)
+				(*i)->prepareNewTurn(getDepth() == 0);
+		}
+		// fires could have been started or stopped.
+		getTileEngine()->calculateTerrainLighting(lightChanges, lightPower);
+	}
+
+	// tiles without fire or smoke have nothing more to do
+	size_t active = 0;
+	for (std::vector<Tile*>::iterator i = _activeTiles.begin(); i != _activeTiles.end(); ++i)
+	{
+		if ((*i)->getFire() == 0 && (*i)->getSmoke() == 0)
+		{
+			(*i)->deactivate();
+		}
+		else
 		{
-			if (getTiles()[i]->getSmoke() != 0)
-				getTiles()[i]->prepareNewTurn(getDepth() == 0);
+			_activeTiles[active++] = *i;
 		}
-		// fires could have been started, stopped or smoke could reveal/conceal units.
-		getTileEngine()->calculateTerrainLighting();
 	}
+	_activeTiles.resize(active);
 
 	reviveUnconsciousUnits();
 }
@@ -51,6 +51,7 @@
 #include "AlienStrategy.h"
 #include "AlienMission.h"
 #include "../Mod/RuleRegion.h"
+#include "../Mod/RuleCountry.h"
 #include "MissionStatistics.h"
 #include "SoldierDeath.h"
 
@@ -410,6 +411,7 @@ void SavedGame::load(const std::string &filename, Mod *mod)
 			AlienBase *b = new AlienBase(mod->getDeployment(deployment));
 			b->load(*i);
 			_alienBases.push_back(b);
+			_targetGrid.add(b);
 		}
 		else
 		{
@@ -443,6 +445,7 @@ void SavedGame::load(const std::string &filename, Mod *mod)
 			Ufo *u = new Ufo(mod->getUfo(type));
 			u->load(*i, *mod, *this);
 			_ufos.push_back(u);
+			_targetGrid.add(u);
 		}
 		else
 		{
@@ -455,6 +458,7 @@ void SavedGame::load(const std::string &filename, Mod *mod)
 		Waypoint *w = new Waypoint();
 		w->load(*i);
 		_waypoints.push_back(w);
+		_targetGrid.add(w);
 	}
 
 	// Backwards compatibility
@@ -467,6 +471,7 @@ void SavedGame::load(const std::string &filename, Mod *mod)
 			MissionSite *m = new MissionSite(mod->getAlienMission(type), mod->getDeployment(deployment));
 			m->load(*i);
 			_missionSites.push_back(m);
+			_targetGrid.add(m);
 		}
 		else
 		{
@@ -483,6 +488,7 @@ void SavedGame::load(const std::string &filename, Mod *mod)
 			MissionSite *m = new MissionSite(mod->getAlienMission(type), mod->getDeployment(deployment));
 			m->load(*i);
 			_missionSites.push_back(m);
+			_targetGrid.add(m);
 		}
 		else
 		{
@@ -509,6 +515,11 @@ void SavedGame::load(const std::string &filename, Mod *mod)
 		Base *b = new Base(mod);
 		b->load(*i, this, false);
 		_bases.push_back(b);
+		_targetGrid.add(b);
+		for (std::vector<Craft*>::iterator j = b->getCrafts()->begin(); j != b->getCrafts()->end(); ++j)
+		{
+			_targetGrid.add(*j);
+		}
 	}
 
 	const YAML::Node &research = doc["poppedResearch"];
@@ -1796,19 +1807,39 @@ void SavedGame::setWarned(bool warned)
 	_warned = warned;
 }
 
-/** @brief Check if a point is contained in a region.
- * This function object checks if a point is contained inside a region.
+/**
+ * Builds a lat/lon grid of the regions and countries, so
+ * locating the ones containing a point doesn't have to check
+ * the areas of all of them. The grid is rebuilt whenever the
+ * number of regions or countries changes.
  */
-class ContainsPoint: public std::unary_function<const Region *, bool>
+void SavedGame::indexGlobe() const
 {
-public:
-	/// Remember the coordinates.
-	ContainsPoint(double lon, double lat) : _lon(lon), _lat(lat) { /* Empty by design. */ }
-	/// Check is the region contains the stored point.
-	bool operator()(const Region *region) const { return region->getRules()->insideRegion(_lon, _lat); }
-private:
-	double _lon, _lat;
-};
+	if (_regionGrid.size() != _regions.size())
+	{
+		_regionGrid.reset(_regions.size());
+		for (size_t i = 0; i < _regions.size(); ++i)
+		{
+			const RuleRegion *rule = _regions[i]->getRules();
+			for (size_t j = 0; j < rule->getLonMin().size(); ++j)
+			{
+				_regionGrid.addArea(i, rule->getLonMin()[j], rule->getLonMax()[j], rule->getLatMin()[j], rule->getLatMax()[j]);
+			}
+		}
+	}
+	if (_countryGrid.size() != _countries.size())
+	{
+		_countryGrid.reset(_countries.size());
+		for (size_t i = 0; i < _countries.size(); ++i)
+		{
+			const RuleCountry *rule = _countries[i]->getRules();
+			for (size_t j = 0; j < rule->getLonMin().size(); ++j)
+			{
+				_countryGrid.addArea(i, rule->getLonMin()[j], rule->getLonMax()[j], rule->getLatMin()[j], rule->getLatMax()[j]);
+			}
+		}
+	}
+}
 
 /**
  * Find the region containing this location.
@@ -1818,10 +1849,14 @@ private:
  */
 Region *SavedGame::locateRegion(double lon, double lat) const
 {
-	std::vector<Region *>::const_iterator found = std::find_if (_regions.begin(), _regions.end(), ContainsPoint(lon, lat));
-	if (found != _regions.end())
+	indexGlobe();
+	const std::vector<size_t> &cell = _regionGrid.getCell(lon, lat);
+	for (std::vector<size_t>::const_iterator i = cell.begin(); i != cell.end(); ++i)
 	{
-		return *found;
+		if (_regions[*i]->getRules()->insideRegion(lon, lat))
+		{
+			return _regions[*i];
+		}
 	}
 	return 0;
 }
@@ -1836,6 +1871,47 @@ Region *SavedGame::locateRegion(const Target &target) const
 	return locateRegion(target.getLongitude(), target.getLatitude());
 }
 
+/**
+ * Find the country containing this location.
+ * @param lon The longtitude.
+ * @param lat The latitude.
+ * @return Pointer to the country, or 0.
+ */
+Country *SavedGame::locateCountry(double lon, double lat) const
+{
+	indexGlobe();
+	const std::vector<size_t> &cell = _countryGrid.getCell(lon, lat);
+	for (std::vector<size_t>::const_iterator i = cell.begin(); i != cell.end(); ++i)
+	{
+		if (_countries[*i]->getRules()->insideCountry(lon, lat))
+		{
+			return _countries[*i];
+		}
+	}
+	return 0;
+}
+
+/**
+ * Find the country containing this target.
+ * @param target The target to locate.
+ * @return Pointer to the country, or 0.
+ */
+Country *SavedGame::locateCountry(const Target &target) const
+{
+	return locateCountry(target.getLongitude(), target.getLatitude());
+}
+
+/**
+ * Returns the grid of targets on the globe. Targets are
+ * added to it when they're created or loaded, update their
+ * own cells as they move, and leave it when deleted.
+ * @return Pointer to the target grid.
+ */
+TargetGrid *SavedGame::getTargetGrid()
+{
+	return &_targetGrid;
+}
+
 /*
  * @return the month counter.
  */
@@ -25,6 +25,8 @@
 #include "GameTime.h"
 #include "../Mod/RuleAlienMission.h"
 #include "../Savegame/Craft.h"
+#include "../Mod/GlobeGrid.h"
+#include "TargetGrid.h"
 
 namespace OpenXcom
 {
@@ -130,8 +132,12 @@ private:
 	size_t _selectedBase;
 	std::string _lastselectedArmor; //contains the last selected armour
 	std::vector<MissionStatistics*> _missionStatistics;
+	mutable GlobeGrid _regionGrid, _countryGrid;
+	TargetGrid _targetGrid;
 
 	static SaveInfo getSaveInfo(const std::string &file, Language *lang);
+	/// Builds the spatial index of regions and countries.
+	void indexGlobe() const;
 public:
 	static const std::string AUTOSAVE_GEOSCAPE, AUTOSAVE_BATTLESCAPE, QUICKSAVE;
 	/// Creates a new saved game.
@@ -278,6 +284,12 @@ public:
 	Region *locateRegion(double lon, double lat) const;
 	/// Locate a region containing a Target.
 	Region *locateRegion(const Target &target) const;
+	/// Locate a country containing a position.
+	Country *locateCountry(double lon, double lat) const;
+	/// Locate a country containing a Target.
+	Country *locateCountry(const Target &target) const;
+	/// Gets the spatial index of all the targets on the globe.
+	TargetGrid *getTargetGrid();
 	/// Return the month counter.
 	int getMonthsPassed() const;
 	/// Return the GraphRegionToggles.
@@ -26,6 +26,16 @@
 namespace OpenXcom
 {
 
+/**
+ * Initializes the totals with nothing counted.
+ */
+SoldierDiaryTotals::SoldierDiaryTotals() : kills(0), weaponKills(0), missions(0),
+	killTotal(0), stunTotal(0), panickTotal(0), controlTotal(0), trapKillTotal(0), reactionFireKillTotal(0),
+	winTotal(0), scoreTotal(0), terrorMissionTotal(0), nightMissionTotal(0), nightTerrorMissionTotal(0), baseDefenseMissionTotal(0),
+	alienBaseAssaultTotal(0), importantMissionTotal(0), valiantCruxTotal(0), lootValueTotal(0)
+{
+}
+
 /**
  * Initializes a new blank diary.
  */
@@ -246,6 +256,9 @@ void SoldierDiary::updateDiary(BattleUnitStatistics *unitStatistics, std::vector
 	_revivedHostileTotal += unitStatistics->revivedHostile;
 	_wholeMedikitTotal += std::min( std::min(unitStatistics->woundsHealed, unitStatistics->appliedStimulant), unitStatistics->appliedPainKill);
 	_missionIdList.push_back(missionStatistics->id);
+	countKills();
+	countWeaponKills(rules);
+	countMissions(allMissionStatistics);
 }
 
 /**
@@ -269,7 +282,9 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 	const std::string battleTypeArray[BATTLE_TYPES] = { "BT_NONE", "BT_FIREARM", "BT_AMMO", "BT_MELEE", "BT_GRENADE",	"BT_PROXIMITYGRENADE", "BT_MEDIKIT", "BT_SCANNER", "BT_MINDPROBE", "BT_PSIAMP", "BT_FLARE", "BT_CORPSE", "BT_END" };
 	const std::string damageTypeArray[DAMAGE_TYPES] = { "DT_NONE", "DT_AP", "DT_IN", "DT_HE", "DT_LASER", "DT_PLASMA", "DT_STUN", "DT_MELEE", "DT_ACID", "DT_SMOKE", "DT_END"};
 
-	const std::map<std::string, RuleCommendations *> commendationsList = mod->getCommendationsList();
+	const std::map<std::string, RuleCommendations *> &commendationsList = mod->getCommendationsList();
+	std::map<std::string, int> criteriaTotals;            // Criteria, soldier's total.
+	getCriteriaTotals(mod, missionStatistics, criteriaTotals);
 	bool awardedCommendation = false;                   // This value is returned if at least one commendation was given.
 	std::map<std::string, int> nextCommendationLevel;   // Noun, threshold.
 	std::vector<std::string> modularCommendations;      // Commendation name.
@@ -301,54 +316,8 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 				break;
 			}
 			// These criteria have no nouns, so only the nextCommendationLevel["noNoun"] will ever be used.
-			else if( nextCommendationLevel.count("noNoun") == 1 &&
-				  ( ((*j).first == "totalKills" && (unsigned int)getKillTotal() < (unsigned int)(*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalMissions" && _missionIdList.size() < (unsigned int)(*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalWins" && getWinTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalScore" && getScoreTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalStuns" && getStunTotal() < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalDaysWounded" && _daysWoundedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalBaseDefenseMissions" && getBaseDefenseMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalTerrorMissions" && getTerrorMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalNightMissions" && getNightMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalNightTerrorMissions" && getNightTerrorMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalMonthlyService" && _monthsService < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalFellUnconcious" && _unconciousTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalShotAt10Times" && _shotAtCounter10in1Mission < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalHit5Times" && _hitCounter5in1Mission < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalFriendlyFired" && (_totalShotByFriendlyCounter < (*j).second.at(nextCommendationLevel["noNoun"]) || _KIA || _MIA)) ||
-					((*j).first == "total_lone_survivor" && _loneSurvivorTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalIronMan" && _ironManTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalImportantMissions" && getImportantMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalLongDistanceHits" && _longDistanceHitCounterTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalLowAccuracyHits" && _lowAccuracyHitCounterTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalReactionFire" && getReactionFireKillTotal(mod) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalTimesWounded" && _timesWoundedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalDaysWounded" && _daysWoundedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalValientCrux" && getValiantCruxTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "isDead" && _KIA < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalTrapKills" && getTrapKillTotal(mod) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAlienBaseAssaults" && getAlienBaseAssaultTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAllAliensKilled" && _allAliensKilledTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAllAliensStunned" && _allAliensStunnedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalWoundsHealed" && _woundsHealedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAllUFOs" && _allUFOs < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAllMissionTypes" && _allMissionTypes < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalStatGain" && _statGainTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalRevives" && _revivedUnitTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalSoldierRevives" && _revivedSoldierTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalHostileRevives" && _revivedHostileTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalNeutralRevives" && _revivedNeutralTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalWholeMedikit" && _wholeMedikitTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalBraveryGain" && _braveryGainTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "bestOfRank" && _bestOfRank < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "bestSoldier" && (int)_bestSoldier < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "isMIA" && _MIA < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalMartyrKills" && _martyrKillsTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalPostMortemKills" && _postMortemKills < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "globeTrotter" && (int)_globeTrotter < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalSlaveKills" && _slaveKillsTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ) )
-
+			else if (nextCommendationLevel.count("noNoun") == 1 && criteriaTotals.count((*j).first) == 1 &&
+				criteriaTotals[(*j).first] < (*j).second.at(nextCommendationLevel["noNoun"]))
 			{
 				awardCommendationBool = false;
 				break;
@@ -357,18 +326,18 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 			// And because they loop over a map<> (this allows for maximum moddability).
 			else if ((*j).first == "totalKillsWithAWeapon" || (*j).first == "totalMissionsInARegion" || (*j).first == "totalKillsByRace" || (*j).first == "totalKillsByRank")
 			{
-				std::map<std::string, int> tempTotal;
+				const std::map<std::string, int> *tempTotal;
 				if ((*j).first == "totalKillsWithAWeapon")
-					tempTotal = getWeaponTotal();
+					tempTotal = &getWeaponTotal();
 				else if ((*j).first == "totalMissionsInARegion")
-					tempTotal = getRegionTotal(missionStatistics);
+					tempTotal = &getRegionTotal(missionStatistics);
 				else if ((*j).first == "totalKillsByRace")
-					tempTotal = getAlienRaceTotal();
-				else if ((*j).first == "totalKillsByRank")
-					tempTotal = getAlienRankTotal();
-				// Loop over the temporary map.
+					tempTotal = &getAlienRaceTotal();
+				else
+					tempTotal = &getAlienRankTotal();
+				// Loop over the soldier's totals.
 				// Match nouns and decoration levels.
-				for(std::map<std::string, int>::const_iterator k = tempTotal.begin(); k != tempTotal.end(); ++k)
+				for(std::map<std::string, int>::const_iterator k = tempTotal->begin(); k != tempTotal->end(); ++k)
 				{
 					int criteria = -1;
 					std::string noun = (*k).first;
@@ -629,143 +598,77 @@ std::vector<BattleUnitKills*> &SoldierDiary::getKills()
  * Get list of kills sorted by rank
  * @return
  */
-std::map<std::string, int> SoldierDiary::getAlienRankTotal()
+const std::map<std::string, int> &SoldierDiary::getAlienRankTotal() const
 {
-	std::map<std::string, int> list;
-	for(std::vector<BattleUnitKills*>::const_iterator kill = _killList.begin(); kill != _killList.end(); ++kill)
-	{
-		list[(*kill)->rank]++;
-	}
-	return list;
+	countKills();
+	return _totals.alienRank;
 }
 
 /**
  *
  */
-std::map<std::string, int> SoldierDiary::getAlienRaceTotal()
+const std::map<std::string, int> &SoldierDiary::getAlienRaceTotal() const
 {
-	std::map<std::string, int> list;
-	for(std::vector<BattleUnitKills*>::const_iterator kill = _killList.begin(); kill != _killList.end(); ++kill)
-	{
-		list[(*kill)->race]++;
-	}
-	return list;
+	countKills();
+	return _totals.alienRace;
 }
 
 /**
  *
  */
-std::map<std::string, int> SoldierDiary::getWeaponTotal()
+const std::map<std::string, int> &SoldierDiary::getWeaponTotal() const
 {
-	std::map<std::string, int> list;
-	for(std::vector<BattleUnitKills*>::const_iterator kill = _killList.begin(); kill != _killList.end(); ++kill)
-	{
-		if ((*kill)->faction == FACTION_HOSTILE)
-			list[(*kill)->weapon]++;
-	}
-	return list;
+	countKills();
+	return _totals.weapon;
 }
 
 /**
  *
  */
-std::map<std::string, int> SoldierDiary::getWeaponAmmoTotal()
+const std::map<std::string, int> &SoldierDiary::getWeaponAmmoTotal() const
 {
-	std::map<std::string, int> list;
-	for(std::vector<BattleUnitKills*>::const_iterator kill = _killList.begin(); kill != _killList.end(); ++kill)
-	{
-		if ((*kill)->faction == FACTION_HOSTILE)
-			list[(*kill)->weaponAmmo]++;
-	}
-	return list;
+	countKills();
+	return _totals.weaponAmmo;
 }
 
 /**
  *  Get a map of the amount of missions done in each region.
  *  @param MissionStatistics
  */
-std::map<std::string, int> SoldierDiary::getRegionTotal(std::vector<MissionStatistics*> *missionStatistics) const
+const std::map<std::string, int> &SoldierDiary::getRegionTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	std::map<std::string, int> regionTotal;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				regionTotal[(*i)->region]++;
-			}
-		}
-	}
-
-	return regionTotal;
+	countMissions(missionStatistics);
+	return _totals.region;
 }
 
 /**
  *  Get a map of the amount of missions done in each country.
  *  @param MissionStatistics
  */
-std::map<std::string, int> SoldierDiary::getCountryTotal(std::vector<MissionStatistics*> *missionStatistics) const
+const std::map<std::string, int> &SoldierDiary::getCountryTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	std::map<std::string, int> countryTotal;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				countryTotal[(*i)->country]++;
-			}
-		}
-	}
-
-	return countryTotal;
+	countMissions(missionStatistics);
+	return _totals.country;
 }
 
 /**
  *  Get a map of the amount of missions done in each type.
  *  @param MissionStatistics
  */
-std::map<std::string, int> SoldierDiary::getTypeTotal(std::vector<MissionStatistics*> *missionStatistics) const
+const std::map<std::string, int> &SoldierDiary::getTypeTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	std::map<std::string, int> typeTotal;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				typeTotal[(*i)->type]++;
-			}
-		}
-	}
-
-	return typeTotal;
+	countMissions(missionStatistics);
+	return _totals.type;
 }
 
 /**
  *  Get a map of the amount of missions done in each UFO.
  *  @param MissionStatistics
  */
-std::map<std::string, int> SoldierDiary::getUFOTotal(std::vector<MissionStatistics*> *missionStatistics) const
+const std::map<std::string, int> &SoldierDiary::getUFOTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	std::map<std::string, int> ufoTotal;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				ufoTotal[(*i)->ufo]++;
-			}
-		}
-	}
-
-	return ufoTotal;
+	countMissions(missionStatistics);
+	return _totals.ufo;
 }
 
 /**
@@ -773,17 +676,8 @@ std::map<std::string, int> SoldierDiary::getUFOTotal(std::vector<MissionStatisti
  */
 int SoldierDiary::getKillTotal() const
 {
-	int killTotal = 0;
-
-	for (std::vector<BattleUnitKills*>::const_iterator i = _killList.begin(); i != _killList.end(); ++i)
-	{
-		if ((*i)->status == STATUS_DEAD && (*i)->faction == FACTION_HOSTILE)
-		{
-			killTotal++;
-		}
-	}
-
-	return killTotal;
+	countKills();
+	return _totals.killTotal;
 }
 
 /**
@@ -800,23 +694,8 @@ int SoldierDiary::getMissionTotal() const
  */
 int SoldierDiary::getWinTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	int winTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success)
-				{
-					winTotal++;
-				}
-			}
-		}
-	}
-
-	return winTotal;
+	countMissions(missionStatistics);
+	return _totals.winTotal;
 }
 
 /**
@@ -824,17 +703,8 @@ int SoldierDiary::getWinTotal(std::vector<MissionStatistics*> *missionStatistics
  */
 int SoldierDiary::getStunTotal() const
 {
-	int stunTotal = 0;
-
-	for (std::vector<BattleUnitKills*>::const_iterator i = _killList.begin(); i != _killList.end(); ++i)
-	{
-		if ((*i)->status == STATUS_UNCONSCIOUS && (*i)->faction == FACTION_HOSTILE)
-		{
-			stunTotal++;
-		}
-	}
-
-	return stunTotal;
+	countKills();
+	return _totals.stunTotal;
 }
 
 /**
@@ -842,17 +712,8 @@ int SoldierDiary::getStunTotal() const
  */
 int SoldierDiary::getPanickTotal() const
 {
-	int panickTotal = 0;
-
-	for (std::vector<BattleUnitKills*>::const_iterator i = _killList.begin(); i != _killList.end(); ++i)
-	{
-		if ((*i)->status == STATUS_PANICKING && (*i)->faction == FACTION_HOSTILE)
-		{
-			panickTotal++;
-		}
-	}
-
-	return panickTotal;
+	countKills();
+	return _totals.panickTotal;
 }
 
 /**
@@ -860,17 +721,8 @@ int SoldierDiary::getPanickTotal() const
  */
 int SoldierDiary::getControlTotal() const
 {
-	int controlTotal = 0;
-
-	for (std::vector<BattleUnitKills*>::const_iterator i = _killList.begin(); i != _killList.end(); ++i)
-	{
-		if ((*i)->status == STATUS_TURNING && (*i)->faction == FACTION_HOSTILE)
-		{
-			controlTotal++;
-		}
-	}
-
-	return controlTotal;
+	countKills();
+	return _totals.controlTotal;
 }
 
 /**
@@ -961,38 +813,18 @@ int SoldierDiary::getAccuracy() const
  */
 int SoldierDiary::getTrapKillTotal(Mod *mod) const
 {
-	int trapKillTotal = 0;
-
-	for (std::vector<BattleUnitKills*>::const_iterator i = _killList.begin(); i != _killList.end(); ++i)
-	{
-		RuleItem *item = mod->getItem((*i)->weapon);
-		if ((*i)->hostileTurn() && (item == 0 || item->getBattleType() == BT_GRENADE || item->getBattleType() == BT_PROXIMITYGRENADE))
-		{
-			trapKillTotal++;
-		}
-	}
-
-	return trapKillTotal;
+	countWeaponKills(mod);
+	return _totals.trapKillTotal;
 }
 
 /**
  *  Get reaction kill total.
  */
- int SoldierDiary::getReactionFireKillTotal(Mod *mod) const
- {
-	int reactionFireKillTotal = 0;
-
-	for (std::vector<BattleUnitKills*>::const_iterator i = _killList.begin(); i != _killList.end(); ++i)
-	{
-		RuleItem *item = mod->getItem((*i)->weapon);
-		if ((*i)->hostileTurn() && item != 0 && item->getBattleType() != BT_GRENADE && item->getBattleType() != BT_PROXIMITYGRENADE)
-		{
-			reactionFireKillTotal++;
-		}
-	}
-
-	return reactionFireKillTotal;
- }
+int SoldierDiary::getReactionFireKillTotal(Mod *mod) const
+{
+	countWeaponKills(mod);
+	return _totals.reactionFireKillTotal;
+}
 
 /**
  *  Get the total of terror missions.
@@ -1000,24 +832,8 @@ int SoldierDiary::getTrapKillTotal(Mod *mod) const
  */
 int SoldierDiary::getTerrorMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	/// Not a UFO, not the base, not the alien base or colony
-	int terrorMissionTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && !(*i)->isBaseDefense() && !(*i)->isUfoMission() && !(*i)->isAlienBase())
-				{
-					terrorMissionTotal++;
-				}
-			}
-		}
-	}
-
-	return terrorMissionTotal;
+	countMissions(missionStatistics);
+	return _totals.terrorMissionTotal;
 }
 
 /**
@@ -1026,23 +842,8 @@ int SoldierDiary::getTerrorMissionTotal(std::vector<MissionStatistics*> *mission
  */
 int SoldierDiary::getNightMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	int nightMissionTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->isDarkness() && !(*i)->isBaseDefense() && !(*i)->isAlienBase())
-				{
-					nightMissionTotal++;
-				}
-			}
-		}
-	}
-
-	return nightMissionTotal;
+	countMissions(missionStatistics);
+	return _totals.nightMissionTotal;
 }
 
 /**
@@ -1051,23 +852,8 @@ int SoldierDiary::getNightMissionTotal(std::vector<MissionStatistics*> *missionS
  */
 int SoldierDiary::getNightTerrorMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	int nightTerrorMissionTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->isDarkness() && !(*i)->isBaseDefense() && !(*i)->isUfoMission() && !(*i)->isAlienBase())
-				{
-					nightTerrorMissionTotal++;
-				}
-			}
-		}
-	}
-
-	return nightTerrorMissionTotal;
+	countMissions(missionStatistics);
+	return _totals.nightTerrorMissionTotal;
 }
 
 /**
@@ -1076,23 +862,8 @@ int SoldierDiary::getNightTerrorMissionTotal(std::vector<MissionStatistics*> *mi
  */
 int SoldierDiary::getBaseDefenseMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	int baseDefenseMissionTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->isBaseDefense())
-				{
-					baseDefenseMissionTotal++;
-				}
-			}
-		}
-	}
-
-	return baseDefenseMissionTotal;
+	countMissions(missionStatistics);
+	return _totals.baseDefenseMissionTotal;
 }
 
 /**
@@ -1101,23 +872,8 @@ int SoldierDiary::getBaseDefenseMissionTotal(std::vector<MissionStatistics*> *mi
  */
 int SoldierDiary::getAlienBaseAssaultTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	int alienBaseAssaultTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->isAlienBase())
-				{
-					alienBaseAssaultTotal++;
-				}
-			}
-		}
-	}
-
-	return alienBaseAssaultTotal;
+	countMissions(missionStatistics);
+	return _totals.alienBaseAssaultTotal;
 }
 
 /**
@@ -1126,23 +882,8 @@ int SoldierDiary::getAlienBaseAssaultTotal(std::vector<MissionStatistics*> *miss
  */
 int SoldierDiary::getImportantMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	int importantMissionTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->type != "STR_UFO_CRASH_RECOVERY")
-				{
-					importantMissionTotal++;
-				}
-			}
-		}
-	}
-
-	return importantMissionTotal;
+	countMissions(missionStatistics);
+	return _totals.importantMissionTotal;
 }
 
 /**
@@ -1151,20 +892,8 @@ int SoldierDiary::getImportantMissionTotal(std::vector<MissionStatistics*> *miss
  */
 int SoldierDiary::getScoreTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	int scoreTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				scoreTotal += (*i)->score;
-			}
-		}
-	}
-
-	return scoreTotal;
+	countMissions(missionStatistics);
+	return _totals.scoreTotal;
 }
 
 /**
@@ -1173,42 +902,214 @@ int SoldierDiary::getScoreTotal(std::vector<MissionStatistics*> *missionStatisti
  */
 int SoldierDiary::getValiantCruxTotal(std::vector<MissionStatistics*> *missionStatistics) const
 {
-	int valiantCruxTotal = 0;
+	countMissions(missionStatistics);
+	return _totals.valiantCruxTotal;
+}
 
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
+/**
+ *  Get the loot value total.
+ *  @param Mission Statistics
+ */
+int SoldierDiary::getLootValueTotal(std::vector<MissionStatistics*> *missionStatistics) const
+{
+	countMissions(missionStatistics);
+	return _totals.lootValueTotal;
+}
+
+/**
+ * Adds the kills since the last count to the totals
+ * of kills by status, rank, race and weapon.
+ */
+void SoldierDiary::countKills() const
+{
+	for (; _totals.kills < _killList.size(); ++_totals.kills)
 	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
+		const BattleUnitKills *kill = _killList[_totals.kills];
+		_totals.alienRank[kill->rank]++;
+		_totals.alienRace[kill->race]++;
+		if (kill->faction == FACTION_HOSTILE)
 		{
-			if ((*j) == (*i)->id && (*i)->valiantCrux)
+			_totals.weapon[kill->weapon]++;
+			_totals.weaponAmmo[kill->weaponAmmo]++;
+			switch (kill->status)
 			{
-				valiantCruxTotal++;
+			case STATUS_DEAD:
+				_totals.killTotal++;
+				break;
+			case STATUS_UNCONSCIOUS:
+				_totals.stunTotal++;
+				break;
+			case STATUS_PANICKING:
+				_totals.panickTotal++;
+				break;
+			case STATUS_TURNING:
+				_totals.controlTotal++;
+				break;
+			default:
+				break;
 			}
 		}
 	}
-
-	return valiantCruxTotal;
 }
 
 /**
- *  Get the loot value total.
- *  @param Mission Statistics
+ * Adds the kills since the last count to the totals
+ * that depend on the type of weapon used.
+ * @param mod Pointer to the mod, for the weapons.
  */
-int SoldierDiary::getLootValueTotal(std::vector<MissionStatistics*> *missionStatistics) const
+void SoldierDiary::countWeaponKills(Mod *mod) const
 {
-	int lootValueTotal = 0;
+	for (; _totals.weaponKills < _killList.size(); ++_totals.weaponKills)
+	{
+		const BattleUnitKills *kill = _killList[_totals.weaponKills];
+		if (!kill->hostileTurn())
+		{
+			continue;
+		}
+		RuleItem *item = mod->getItem(kill->weapon);
+		if (item == 0 || item->getBattleType() == BT_GRENADE || item->getBattleType() == BT_PROXIMITYGRENADE)
+		{
+			_totals.trapKillTotal++;
+		}
+		else
+		{
+			_totals.reactionFireKillTotal++;
+		}
+	}
+}
 
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
+/**
+ * Adds the missions since the last count to the totals
+ * of missions by outcome, region, country, type and UFO.
+ * @param missionStatistics List of all the missions.
+ */
+void SoldierDiary::countMissions(std::vector<MissionStatistics*> *missionStatistics) const
+{
+	for (; _totals.missions < _missionIdList.size(); ++_totals.missions)
 	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
+		int id = _missionIdList[_totals.missions];
+		// missions are numbered in the order they're stored
+		MissionStatistics *mission = 0;
+		if (id >= 0 && (size_t)id < missionStatistics->size() && missionStatistics->at(id)->id == id)
 		{
-			if ((*j) == (*i)->id)
+			mission = missionStatistics->at(id);
+		}
+		else
+		{
+			for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
+			{
+				if ((*i)->id == id)
+				{
+					mission = *i;
+					break;
+				}
+			}
+		}
+		if (mission == 0)
+		{
+			continue;
+		}
+
+		_totals.region[mission->region]++;
+		_totals.country[mission->country]++;
+		_totals.type[mission->type]++;
+		_totals.ufo[mission->ufo]++;
+		_totals.scoreTotal += mission->score;
+		_totals.lootValueTotal += mission->lootValue;
+		if (mission->valiantCrux)
+		{
+			_totals.valiantCruxTotal++;
+		}
+		if (mission->success)
+		{
+			_totals.winTotal++;
+			// Not a UFO, not the base, not the alien base or colony
+			if (!mission->isBaseDefense() && !mission->isUfoMission() && !mission->isAlienBase())
 			{
-				lootValueTotal += (*i)->lootValue;
+				_totals.terrorMissionTotal++;
+			}
+			if (mission->isDarkness() && !mission->isBaseDefense() && !mission->isAlienBase())
+			{
+				_totals.nightMissionTotal++;
+				if (!mission->isUfoMission())
+				{
+					_totals.nightTerrorMissionTotal++;
+				}
+			}
+			if (mission->isBaseDefense())
+			{
+				_totals.baseDefenseMissionTotal++;
+			}
+			if (mission->isAlienBase())
+			{
+				_totals.alienBaseAssaultTotal++;
+			}
+			if (mission->type != "STR_UFO_CRASH_RECOVERY")
+			{
+				_totals.importantMissionTotal++;
 			}
 		}
 	}
+}
 
-	return lootValueTotal;
+/**
+ * Gets the soldier's totals for each commendation criteria
+ * that doesn't have a noun, so they can be looked up by name.
+ * @param mod Pointer to the mod.
+ * @param missionStatistics List of all the missions.
+ * @param totals Map to fill with the totals.
+ */
+void SoldierDiary::getCriteriaTotals(Mod *mod, std::vector<MissionStatistics*> *missionStatistics, std::map<std::string, int> &totals) const
+{
+	countKills();
+	countWeaponKills(mod);
+	countMissions(missionStatistics);
+	totals["totalKills"] = _totals.killTotal;
+	totals["totalMissions"] = _missionIdList.size();
+	totals["totalWins"] = _totals.winTotal;
+	totals["totalScore"] = _totals.scoreTotal;
+	totals["totalStuns"] = _totals.stunTotal;
+	totals["totalDaysWounded"] = _daysWoundedTotal;
+	totals["totalBaseDefenseMissions"] = _totals.baseDefenseMissionTotal;
+	totals["totalTerrorMissions"] = _totals.terrorMissionTotal;
+	totals["totalNightMissions"] = _totals.nightMissionTotal;
+	totals["totalNightTerrorMissions"] = _totals.nightTerrorMissionTotal;
+	totals["totalMonthlyService"] = _monthsService;
+	totals["totalFellUnconcious"] = _unconciousTotal;
+	totals["totalShotAt10Times"] = _shotAtCounter10in1Mission;
+	totals["totalHit5Times"] = _hitCounter5in1Mission;
+	// friendly fire doesn't count for soldiers who didn't make it
+	totals["totalFriendlyFired"] = (_KIA || _MIA) ? -1 : _totalShotByFriendlyCounter;
+	totals["total_lone_survivor"] = _loneSurvivorTotal;
+	totals["totalIronMan"] = _ironManTotal;
+	totals["totalImportantMissions"] = _totals.importantMissionTotal;
+	totals["totalLongDistanceHits"] = _longDistanceHitCounterTotal;
+	totals["totalLowAccuracyHits"] = _lowAccuracyHitCounterTotal;
+	totals["totalReactionFire"] = _totals.reactionFireKillTotal;
+	totals["totalTimesWounded"] = _timesWoundedTotal;
+	totals["totalValientCrux"] = _totals.valiantCruxTotal;
+	totals["isDead"] = _KIA;
+	totals["totalTrapKills"] = _totals.trapKillTotal;
+	totals["totalAlienBaseAssaults"] = _totals.alienBaseAssaultTotal;
+	totals["totalAllAliensKilled"] = _allAliensKilledTotal;
+	totals["totalAllAliensStunned"] = _allAliensStunnedTotal;
+	totals["totalWoundsHealed"] = _woundsHealedTotal;
+	totals["totalAllUFOs"] = _allUFOs;
+	totals["totalAllMissionTypes"] = _allMissionTypes;
+	totals["totalStatGain"] = _statGainTotal;
+	totals["totalRevives"] = _revivedUnitTotal;
+	totals["totalSoldierRevives"] = _revivedSoldierTotal;
+	totals["totalHostileRevives"] = _revivedHostileTotal;
+	totals["totalNeutralRevives"] = _revivedNeutralTotal;
+	totals["totalWholeMedikit"] = _wholeMedikitTotal;
+	totals["totalBraveryGain"] = _braveryGainTotal;
+	totals["bestOfRank"] = _bestOfRank;
+	totals["bestSoldier"] = (int)_bestSoldier;
+	totals["isMIA"] = _MIA;
+	totals["totalMartyrKills"] = _martyrKillsTotal;
+	totals["totalPostMortemKills"] = _postMortemKills;
+	totals["globeTrotter"] = (int)_globeTrotter;
+	totals["totalSlaveKills"] = _slaveKillsTotal;
 }
 
 /**
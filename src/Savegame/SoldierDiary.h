@@ -67,6 +67,22 @@ public:
 	void addDecoration();
 };
 
+/**
+ * Totals of a soldier's kills and missions, added to as the diary
+ * grows so they don't have to be counted over the whole career
+ * every time. They aren't saved, since they come from the diary.
+ */
+struct SoldierDiaryTotals
+{
+	size_t kills, weaponKills, missions;
+	int killTotal, stunTotal, panickTotal, controlTotal, trapKillTotal, reactionFireKillTotal;
+	int winTotal, scoreTotal, terrorMissionTotal, nightMissionTotal, nightTerrorMissionTotal, baseDefenseMissionTotal,
+		alienBaseAssaultTotal, importantMissionTotal, valiantCruxTotal, lootValueTotal;
+	std::map<std::string, int> alienRank, alienRace, weapon, weaponAmmo, region, country, type, ufo;
+	/// Creates empty totals.
+	SoldierDiaryTotals();
+};
+
 class SoldierDiary
 {
 private:
@@ -79,7 +95,16 @@ private:
 		_woundsHealedTotal, _allUFOs, _allMissionTypes, _statGainTotal, _revivedUnitTotal, _wholeMedikitTotal, _braveryGainTotal, _bestOfRank, _MIA,
 		_martyrKillsTotal, _postMortemKills, _slaveKillsTotal, _bestSoldier, _revivedSoldierTotal, _revivedHostileTotal, _revivedNeutralTotal;
 	bool _globeTrotter;
+	mutable SoldierDiaryTotals _totals;
 	void awardCommendation(const std::string& type, const std::string& noun = "noNoun");
+	/// Adds the kills that weren't counted yet to the totals.
+	void countKills() const;
+	/// Adds the kills that weren't counted yet to the totals by weapon type.
+	void countWeaponKills(Mod *mod) const;
+	/// Adds the missions that weren't counted yet to the totals.
+	void countMissions(std::vector<MissionStatistics*> *missionStatistics) const;
+	/// Gets the totals for the commendation criteria without nouns.
+	void getCriteriaTotals(Mod *mod, std::vector<MissionStatistics*> *missionStatistics, std::map<std::string, int> &totals) const;
 public:
 	/// Construct a diary.
 	SoldierDiary();
@@ -92,21 +117,21 @@ public:
 	/// Update the diary statistics.
 	void updateDiary(BattleUnitStatistics*, std::vector<MissionStatistics*>*, Mod*);
 	/// Get the list of kills, mapped by rank.
-	std::map<std::string, int> getAlienRankTotal();
+	const std::map<std::string, int> &getAlienRankTotal() const;
 	/// Get the list of kills, mapped by race.
-	std::map<std::string, int> getAlienRaceTotal();
+	const std::map<std::string, int> &getAlienRaceTotal() const;
 	/// Get the list of kills, mapped by weapon used.
-	std::map<std::string, int> getWeaponTotal();
+	const std::map<std::string, int> &getWeaponTotal() const;
 	/// Get the list of kills, mapped by weapon ammo used.
-	std::map<std::string, int> getWeaponAmmoTotal();
+	const std::map<std::string, int> &getWeaponAmmoTotal() const;
 	/// Get the list of missions, mapped by region.
-	std::map<std::string, int> getRegionTotal(std::vector<MissionStatistics*>*) const;
+	const std::map<std::string, int> &getRegionTotal(std::vector<MissionStatistics*>*) const;
 	/// Get the list of missions, mapped by country.
-	std::map<std::string, int> getCountryTotal(std::vector<MissionStatistics*>*) const;
+	const std::map<std::string, int> &getCountryTotal(std::vector<MissionStatistics*>*) const;
 	/// Get the list of missions, mapped by type.
-	std::map<std::string, int> getTypeTotal(std::vector<MissionStatistics*>*) const;
+	const std::map<std::string, int> &getTypeTotal(std::vector<MissionStatistics*>*) const;
 	/// Get the list of missions, mapped by UFO.
-	std::map<std::string, int> getUFOTotal(std::vector<MissionStatistics*>*) const;
+	const std::map<std::string, int> &getUFOTotal(std::vector<MissionStatistics*>*) const;
 	/// Get the total number of kills.
 	int getKillTotal() const;
 	/// Get the total number of missions.
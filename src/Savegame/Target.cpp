@@ -18,6 +18,7 @@
  */
 #include "Target.h"
 #include "Craft.h"
+#include "TargetGrid.h"
 #include "SerializationHelper.h"
 #include "../fmath.h"
 #include "../Engine/Language.h"
@@ -28,15 +29,20 @@ namespace OpenXcom
 /**
  * Initializes a target with blank coordinates.
  */
-Target::Target() : _lon(0.0), _lat(0.0), _id(0)
+Target::Target() : _lon(0.0), _lat(0.0), _id(0), _grid(0), _gridCell(0)
 {
 }
 
 /**
- * Make sure no crafts are chasing this target.
+ * Make sure no crafts are chasing this target
+ * and take it off the target grid.
  */
 Target::~Target()
 {
+	if (_grid != 0)
+	{
+		_grid->remove(this);
+	}
 	std::vector<Craft*> followers = getCraftFollowers();
 	for (std::vector<Craft*>::iterator i = followers.begin(); i != followers.end(); ++i)
 	{
@@ -111,6 +117,11 @@ void Target::setLongitude(double lon)
 		_lon += 2 * M_PI;
 	while (_lon >= 2 * M_PI)
 		_lon -= 2 * M_PI;
+
+	if (_grid != 0)
+	{
+		_grid->update(this);
+	}
 }
 
 /**
@@ -140,6 +151,11 @@ void Target::setLatitude(double lat)
 		_lat = M_PI - _lat;
 		setLongitude(_lon - M_PI);
 	}
+
+	if (_grid != 0)
+	{
+		_grid->update(this);
+	}
 }
 
 /**
@@ -27,6 +27,7 @@ namespace OpenXcom
 class Language;
 class MovingTarget;
 class Craft;
+class TargetGrid;
 
 /**
  * Base class for targets on the globe
@@ -39,6 +40,8 @@ protected:
 	int _id;
 	std::string _name;
 	std::vector<MovingTarget*> _followers;
+	TargetGrid *_grid;
+	int _gridCell;
 	/// Creates a target.
 	Target();
 public:
@@ -84,6 +87,8 @@ public:
 	double getDistance(const Target *target) const { return getDistance(target->getLongitude(), target->getLatitude()); }
 	/// Gets the distance to another position.
 	double getDistance(double lon, double lat) const;
+
+	friend class TargetGrid;
 };
 
 }
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TargetGrid.h"
+#include <algorithm>
+#include "Target.h"
+#include "../fmath.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates an empty grid with all the cells allocated.
+ */
+TargetGrid::TargetGrid() : _cells(CELLS_LON * CELLS_LAT)
+{
+}
+
+/**
+ * Detaches all the targets still in the grid.
+ */
+TargetGrid::~TargetGrid()
+{
+	for (std::vector<std::vector<Target*> >::iterator i = _cells.begin(); i != _cells.end(); ++i)
+	{
+		for (std::vector<Target*>::iterator j = i->begin(); j != i->end(); ++j)
+		{
+			(*j)->_grid = 0;
+		}
+	}
+}
+
+/**
+ * Gets the index of the cell containing a point.
+ * @param lon Longitude in radians.
+ * @param lat Latitude in radians.
+ * @return Cell index.
+ */
+int TargetGrid::getCell(double lon, double lat)
+{
+	int col = Clamp((int)(lon * CELLS_LON / (2 * M_PI)), 0, CELLS_LON - 1);
+	int row = Clamp((int)std::floor((lat + M_PI_2) * CELLS_LAT / M_PI), 0, CELLS_LAT - 1);
+	return row * CELLS_LON + col;
+}
+
+/**
+ * Adds a target to the cell it's currently in.
+ * @param target Pointer to target.
+ */
+void TargetGrid::add(Target *target)
+{
+	if (target->_grid != 0)
+	{
+		target->_grid->remove(target);
+	}
+	int cell = getCell(target->getLongitude(), target->getLatitude());
+	_cells[cell].push_back(target);
+	target->_grid = this;
+	target->_gridCell = cell;
+}
+
+/**
+ * Removes a target from the grid.
+ * @param target Pointer to target.
+ */
+void TargetGrid::remove(Target *target)
+{
+	if (target->_grid != this)
+		return;
+	std::vector<Target*> &cell = _cells[target->_gridCell];
+	std::vector<Target*>::iterator i = std::find(cell.begin(), cell.end(), target);
+	if (i != cell.end())
+	{
+		*i = cell.back();
+		cell.pop_back();
+	}
+	target->_grid = 0;
+}
+
+/**
+ * Moves a target to another cell if it left its old one.
+ * @param target Pointer to target.
+ */
+void TargetGrid::update(Target *target)
+{
+	if (target->_grid != this)
+		return;
+	int cell = getCell(target->getLongitude(), target->getLatitude());
+	if (cell != target->_gridCell)
+	{
+		remove(target);
+		add(target);
+	}
+}
+
+/**
+ * Gets all the targets in the cells that overlap a circle
+ * on the globe. It's up to the caller to check the actual
+ * distance to each of them.
+ * @param lon Longitude of the center in radians.
+ * @param lat Latitude of the center in radians.
+ * @param radius Radius of the circle in radians.
+ * @param targets List to fill with the targets, sorted by pointer for quick lookups.
+ */
+void TargetGrid::getNear(double lon, double lat, double radius, std::vector<Target*> &targets) const
+{
+	targets.clear();
+	const double cellLon = 2 * M_PI / CELLS_LON, cellLat = M_PI / CELLS_LAT;
+	radius += 1e-9;
+	double latMin = lat - radius, latMax = lat + radius;
+	int row1 = Clamp((int)std::floor((latMin + M_PI_2) / cellLat), 0, CELLS_LAT - 1);
+	int row2 = Clamp((int)std::floor((latMax + M_PI_2) / cellLat), 0, CELLS_LAT - 1);
+	int col1 = 0, cols = CELLS_LON;
+	// the circle only spans a few columns unless it goes over a pole
+	if (radius < M_PI_2 && latMin > -M_PI_2 && latMax < M_PI_2 && std::sin(radius) < std::cos(lat))
+	{
+		double dlon = std::asin(std::sin(radius) / std::cos(lat));
+		col1 = (int)std::floor((lon - dlon) / cellLon);
+		int col2 = (int)std::floor((lon + dlon) / cellLon);
+		cols = std::min(col2 - col1 + 1, (int)CELLS_LON);
+		col1 = (col1 % CELLS_LON + CELLS_LON) % CELLS_LON;
+	}
+	for (int row = row1; row <= row2; ++row)
+	{
+		for (int c = 0; c < cols; ++c)
+		{
+			const std::vector<Target*> &cell = _cells[row * CELLS_LON + (col1 + c) % CELLS_LON];
+			targets.insert(targets.end(), cell.begin(), cell.end());
+		}
+	}
+	std::sort(targets.begin(), targets.end());
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+namespace OpenXcom
+{
+
+class Target;
+
+/**
+ * Spatial hash of the targets on the globe.
+ * Splits the globe into a lat/lon grid and keeps track of which
+ * targets are in each cell, so range checks only need to look at
+ * the targets close by instead of every one of them.
+ * Targets keep their cell up to date as they move.
+ */
+class TargetGrid
+{
+private:
+	static const int CELLS_LON = 72;
+	static const int CELLS_LAT = 36;
+	std::vector<std::vector<Target*> > _cells;
+
+	/// Gets the cell containing a point.
+	static int getCell(double lon, double lat);
+public:
+	/// Creates an empty grid.
+	TargetGrid();
+	/// Cleans up the grid.
+	~TargetGrid();
+	/// Adds a target to the grid.
+	void add(Target *target);
+	/// Removes a target from the grid.
+	void remove(Target *target);
+	/// Moves a target to its current cell.
+	void update(Target *target);
+	/// Gets the targets that may be within a distance of a point.
+	void getNear(double lon, double lat, double radius, std::vector<Target*> &targets) const;
+};
+
+}
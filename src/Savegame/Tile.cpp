@@ -49,7 +49,7 @@ Tile::SerializationKey Tile::serializationKey =
  * constructor
  * @param pos Position.
  */
-Tile::Tile(Position pos): _smoke(0), _fire(0), _explosive(0), _explosiveType(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false), _preview(-1), _TUMarker(-1), _overlaps(0), _danger(false), _obstacle(0)
+Tile::Tile(Position pos): _smoke(0), _fire(0), _explosive(0), _explosiveType(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false), _preview(-1), _TUMarker(-1), _overlaps(0), _danger(false), _obstacle(0), _terrainRevision(0), _activeTiles(0), _active(false)
 {
 	for (int i = 0; i < 4; ++i)
 	{
@@ -114,6 +114,7 @@ void Tile::load(const YAML::Node &node)
 	if (_fire || _smoke)
 	{
 		_animationOffset = std::rand() % 4;
+		activate();
 	}
 }
 
@@ -145,6 +146,7 @@ void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 	if (_fire || _smoke)
 	{
 		_animationOffset = std::rand() % 4;
+		activate();
 	}
 }
 
@@ -220,6 +222,7 @@ void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, TilePart pa
 	_objects[part] = dat;
 	_mapDataID[part] = mapDataID;
 	_mapDataSetID[part] = mapDataSetID;
+	++_terrainRevision;
 }
 
 /**
@@ -357,6 +360,7 @@ int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve)
 		if (unit &&	unit->getTimeUnits() < _objects[part]->getTUCost(unit->getMovementType()) + unit->getActionTUs(reserve, unit->getMainHandWeapon(false)))
 			return 4;
 		_currentFrame[part] = 1; // start opening door
+		++_terrainRevision;
 		return 1;
 	}
 	if (_objects[part]->isUFODoor() && _currentFrame[part] != 7) // ufo door != part 7 - door is still opening
@@ -375,6 +379,7 @@ int Tile::closeUfoDoor()
 		if (isUfoDoorOpen((TilePart)part))
 		{
 			_currentFrame[part] = 0;
+			++_terrainRevision;
 			retval = 1;
 		}
 	}
@@ -613,6 +618,7 @@ void Tile::ignite(int power)
 				_overlaps = 1;
 				_fire = getFuel() + 1;
 				_animationOffset = RNG::generate(0,3);
+				activate();
 			}
 		}
 	}
@@ -695,6 +701,10 @@ void Tile::setFire(int fire)
 {
 	_fire = fire;
 	_animationOffset = RNG::generate(0,3);
+	if (_fire)
+	{
+		activate();
+	}
 }
 
 /**
@@ -724,6 +734,7 @@ void Tile::addSmoke(int smoke)
 		}
 		_animationOffset = RNG::generate(0,3);
 		addOverlap();
+		activate();
 	}
 }
 
@@ -735,6 +746,10 @@ void Tile::setSmoke(int smoke)
 {
 	_smoke = smoke;
 	_animationOffset = RNG::generate(0,3);
+	if (_smoke)
+	{
+		activate();
+	}
 }
 
 
@@ -965,6 +980,10 @@ void Tile::addOverlap()
 void Tile::setDangerous(bool danger)
 {
 	_danger = danger;
+	if (_danger)
+	{
+		activate();
+	}
 }
 
 /**
@@ -1010,4 +1029,36 @@ void Tile::resetObstacle(void)
 	_obstacle = 0;
 }
 
+/**
+ * Sets the list of tiles with fire, smoke or danger on them,
+ * which this tile adds itself to whenever it gets any of them,
+ * so the end of turn doesn't need to look at the whole map.
+ * @param activeTiles Pointer to the list.
+ */
+void Tile::setActiveList(std::vector<Tile*> *activeTiles)
+{
+	_activeTiles = activeTiles;
+}
+
+/**
+ * Adds this tile to the active list, if it isn't there already.
+ */
+void Tile::activate()
+{
+	if (!_active && _activeTiles)
+	{
+		_active = true;
+		_activeTiles->push_back(this);
+	}
+}
+
+/**
+ * Lets the tile know it's been taken out of the active list,
+ * so it can add itself again later.
+ */
+void Tile::deactivate()
+{
+	_active = false;
+}
+
 }
@@ -80,6 +80,12 @@ protected:
 	bool _danger;
 	std::list<Particle*> _particles;
 	int _obstacle;
+	int _terrainRevision;
+	std::vector<Tile*> *_activeTiles;
+	bool _active;
+
+	/// Adds this tile to the list of tiles with fire, smoke or danger.
+	void activate();
 public:
 	/// Creates a tile.
 	Tile(Position pos);
@@ -145,6 +151,16 @@ public:
 		return (_objects[part] && _objects[part]->isUFODoor() && _currentFrame[part] != 0);
 	}
 
+	/**
+	 * Gets a counter that changes every time the terrain
+	 * parts of this tile change or a ufo door opens or closes.
+	 * @return Terrain revision.
+	 */
+	int getTerrainRevision() const
+	{
+		return _terrainRevision;
+	}
+
 	/// Close ufo door.
 	int closeUfoDoor();
 	/// Sets the black fog of war status of this tile.
@@ -256,6 +272,15 @@ public:
 	}
 	/// reset obstacle flags
 	void resetObstacle(void);
+	/// Sets the list this tile joins when it gets fire, smoke or danger.
+	void setActiveList(std::vector<Tile*> *activeTiles);
+	/// Is this tile in the list of tiles with fire, smoke or danger?
+	bool isActive() const
+	{
+		return _active;
+	}
+	/// Marks this tile as taken out of the active list.
+	void deactivate();
 };
 
 }